@@ -0,0 +1,203 @@
+// Мікро- і макробенчмарки GA/GWO на Google Benchmark.
+// Кожен бенчмарк звітує per_individual (час однієї ітерації на одну особину) і, для поколінь, generations/s.
+// Приклад: Optimizer_Bench --benchmark_filter=GA_RunGeneration --benchmark_min_time=0.2
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <vector>
+#include "ThreadPool.cpp"
+#include "TestFunctions.cpp"
+#include "GA.cpp"
+#include "GWO.cpp"
+#include "DrawScene.cpp"
+
+namespace {
+
+const uint64_t BenchmarkSeed = 1;
+
+ThreadPool* SharedPool() {
+    static ThreadPool pool;
+    return &pool;
+}
+
+// Час ітерації, поділений на count; Google Benchmark показує його з префіксом, напр. 120.7ns
+void SetPerIndividual(benchmark::State& state, size_t count) {
+    state.counters["per_individual"] = benchmark::Counter(static_cast<double>(count),
+                                                          benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void SetGenerationsPerSecond(benchmark::State& state) {
+    state.counters["generations/s"] = benchmark::Counter(1.0, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Популяція з рівномірно випадковими межами [-10, 10], уже оцінена
+GeneticAlgorithm<1> MakeGeneticAlgorithm(size_t populationSize, size_t chromosomeLength, float crossoverRate = 0.8f) {
+    GeneticAlgorithm<1> ga;
+    ga.Initialize(populationSize, chromosomeLength, -10.0f, 10.0f, crossoverRate, 0.1f, BenchmarkSeed);
+    ga.EvaluateFitness(Rastrigin{});
+    return ga;
+}
+
+// Окремий буфер геномів для бенчмарків операторів: по одному слову на особину
+std::vector<uint64_t> RandomGenomes(size_t count, size_t chromosomeLength) {
+    Xoshiro256PlusPlus gen(BenchmarkSeed, 1);
+    uint64_t mask = (chromosomeLength >= 64) ? ~uint64_t(0) : (uint64_t(1) << chromosomeLength) - 1;
+    std::vector<uint64_t> genomes(count);
+    for (uint64_t& genome : genomes) genome = gen() & mask;
+    return genomes;
+}
+
+// Аргументи: розмір популяції, довжина хромосоми, (для поколінь) 1 - із пулом потоків
+void PopulationAndChromosome(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({ "population", "bits" });
+    bench->ArgsProduct({ benchmark::CreateRange(10, 1000000, 10), { 8, 16, 32, 64 } });
+}
+
+void PopulationChromosomeAndThreads(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({ "population", "bits", "threads" });
+    bench->ArgsProduct({ benchmark::CreateRange(10, 1000000, 10), { 8, 16, 32, 64 }, { 0, 1 } });
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+// Для бенчмарків, яким довжина хромосоми не потрібна
+void PopulationOnly(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("population");
+    bench->RangeMultiplier(10)->Range(10, 1000000);
+}
+
+void PopulationAndThreads(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({ "population", "threads" });
+    bench->ArgsProduct({ benchmark::CreateRange(10, 1000000, 10), { 0, 1 } });
+    bench->Unit(benchmark::kMicrosecond);
+}
+
+void BM_GA_RunGeneration(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    GeneticAlgorithm<1> ga = MakeGeneticAlgorithm(populationSize, static_cast<size_t>(state.range(1)));
+    ga.SetThreadPool(state.range(2) ? SharedPool() : nullptr);
+    for (auto _ : state) {
+        ga.RunGeneration(Rastrigin{});
+    }
+    SetPerIndividual(state, populationSize);
+    SetGenerationsPerSecond(state);
+}
+BENCHMARK(BM_GA_RunGeneration)->Apply(PopulationChromosomeAndThreads);
+
+void BM_GA_Crossover(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    size_t chromosomeLength = static_cast<size_t>(state.range(1));
+    GeneticAlgorithm<1> ga = MakeGeneticAlgorithm(10, chromosomeLength, 1.0f);
+    std::vector<uint64_t> parents = RandomGenomes(populationSize, chromosomeLength);
+    std::vector<uint64_t> children(populationSize);
+    for (auto _ : state) {
+        for (size_t i = 0; i < populationSize; ++i) {
+            ga.Crossover(&parents[i], &parents[(i + 1) % populationSize], &children[i]);
+        }
+        benchmark::DoNotOptimize(children.data());
+        benchmark::ClobberMemory();
+    }
+    SetPerIndividual(state, populationSize);
+}
+BENCHMARK(BM_GA_Crossover)->Apply(PopulationAndChromosome);
+
+void BM_GA_Mutate(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    size_t chromosomeLength = static_cast<size_t>(state.range(1));
+    GeneticAlgorithm<1> ga = MakeGeneticAlgorithm(10, chromosomeLength);
+    std::vector<uint64_t> genomes = RandomGenomes(populationSize, chromosomeLength);
+    for (auto _ : state) {
+        for (uint64_t& genome : genomes) {
+            ga.Mutate(&genome);
+        }
+        benchmark::DoNotOptimize(genomes.data());
+        benchmark::ClobberMemory();
+    }
+    SetPerIndividual(state, populationSize);
+}
+BENCHMARK(BM_GA_Mutate)->Apply(PopulationAndChromosome);
+
+void BM_GA_BinaryToFloat(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    size_t chromosomeLength = static_cast<size_t>(state.range(1));
+    GeneticAlgorithm<1> ga = MakeGeneticAlgorithm(10, chromosomeLength);
+    std::vector<uint64_t> genomes = RandomGenomes(populationSize, chromosomeLength);
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (const uint64_t& genome : genomes) {
+            sum += ga.BinaryToFloat(&genome);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    SetPerIndividual(state, populationSize);
+}
+BENCHMARK(BM_GA_BinaryToFloat)->Apply(PopulationAndChromosome);
+
+// Один турнір на особину, як у RunGeneration (там - по два на нащадка)
+void BM_GA_TournamentSelection(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    GeneticAlgorithm<1> ga = MakeGeneticAlgorithm(populationSize, 16);
+    std::vector<size_t> winners(populationSize);
+    for (auto _ : state) {
+        ga.SelectParents(winners.data(), winners.size(), 3);
+        benchmark::DoNotOptimize(winners.data());
+        benchmark::ClobberMemory();
+    }
+    SetPerIndividual(state, populationSize);
+}
+BENCHMARK(BM_GA_TournamentSelection)->Apply(PopulationOnly);
+
+void BM_GWO_RunGeneration(benchmark::State& state) {
+    size_t populationSize = static_cast<size_t>(state.range(0));
+    GreyWolfOptimizer<1> gwo;
+    gwo.Initialize(populationSize, -10.0f, 10.0f, BenchmarkSeed);
+    gwo.SetThreadPool(state.range(1) ? SharedPool() : nullptr);
+    for (auto _ : state) {
+        gwo.RunGeneration(Rastrigin{});
+    }
+    SetPerIndividual(state, populationSize);
+    SetGenerationsPerSecond(state);
+}
+BENCHMARK(BM_GWO_RunGeneration)->Apply(PopulationAndThreads);
+
+// Ядра тестових функцій на одному рівні SIMD; рівні, яких процесор не має, пропускаються
+void BM_EvaluateTestFunction(benchmark::State& state) {
+    SimdLevel level = static_cast<SimdLevel>(state.range(2));
+    if (level > DetectSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+    const size_t pointCount = 4096;
+    size_t dimensions = static_cast<size_t>(state.range(1));
+    std::vector<float> xs(pointCount * dimensions);
+    Xoshiro256PlusPlus gen(BenchmarkSeed, 2);
+    for (float& x : xs) x = -10.0f + 20.0f * UnitFloat(static_cast<uint32_t>(gen() >> 32));
+    std::vector<float> out(pointCount);
+    SetSimdLevel(level);
+    for (auto _ : state) {
+        EvaluateTestFunction(static_cast<TestFunctionId>(state.range(0)), xs, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    SetSimdLevel(DetectSimdLevel());
+    state.SetLabel(SimdLevelName(level));
+    SetPerIndividual(state, pointCount);
+}
+BENCHMARK(BM_EvaluateTestFunction)
+    ->ArgNames({ "function", "dimensions", "simd" })
+    ->ArgsProduct({ { 0, 1, 2 }, { 1, 16 }, { 0, 1, 2, 3 } });
+
+// Графік у GUI: функція приходить через std::function, як у main.cpp. Особини тут - точки графіка
+void BM_FunctionDrawer_PrecomputeFunction(benchmark::State& state) {
+    FunctionDrawer drawer;
+    WithTestFunction(static_cast<int>(state.range(0)), [&](auto function) {
+        drawer.Initialize(-10.0f, 10.0f, std::function<float(float)>([function](float x) { return function(x); }));
+    });
+    for (auto _ : state) {
+        drawer.PrecomputeFunction();
+    }
+    SetPerIndividual(state, static_cast<size_t>(drawer.GetResolution()));
+}
+BENCHMARK(BM_FunctionDrawer_PrecomputeFunction)->ArgName("function")->DenseRange(0, TestFunctionCount - 1);
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,334 @@
+// Час до цілі: GA і GWO на кількох функціях і багатьох seed. Прогін зупиняється, щойно найкраще значення
+// ввійде в epsilon від відомого оптимуму; записуються покоління, виклики функції і час від Initialize.
+// Результати - три CSV: окремі прогони, перцентилі та ECDF за викликами і за часом
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ThreadPool.cpp"
+#include "TestFunctions.cpp"
+#include "GA.cpp"
+#include "GWO.cpp"
+
+// Стандартна область пошуку й відомий мінімум; function - індекс як у WithTestFunction
+struct Problem {
+    const char* name;
+    int function;
+    float searchMin, searchMax;
+    float optimum;
+};
+
+const Problem problems[] = {
+    { "parabola", 0, -10.0f, 10.0f, 0.0f },
+    { "rastrigin", 1, -5.12f, 5.12f, 0.0f },
+    { "custom", 2, -10.0f, 10.0f, -2.0f },
+    { "ackley", 3, -32.768f, 32.768f, 0.0f },
+    { "griewank", 4, -600.0f, 600.0f, 0.0f },
+};
+
+const char* algorithmNames[] = { "ga", "gwo" };
+const char* engineNames[] = { "xoshiro", "pcg64", "philox" };
+
+struct HarnessOptions {
+    std::vector<int> algorithms = { 0, 1 };
+    std::vector<size_t> problems = { 0, 1, 3, 4 };
+    uint64_t firstSeed = 1;
+    int seeds = 30;
+    size_t dimensions = 1;
+    size_t populationSize = 50;
+    int maxGenerations = 1000;
+    float epsilon = 1e-3f;
+    size_t threads = 1; // 0 - усі ядра, 1 - без пулу
+    int engine = 0;     // індекс як у WithRandomEngine
+    std::string output = "ttt";
+    size_t chromosomeLength = 16;
+    float crossoverRate = 0.8f;
+    float mutationRate = 0.1f;
+    bool fitnessCache = false;
+};
+
+struct RunResult {
+    int algorithm;
+    size_t problem;
+    uint64_t seed;
+    bool reached;
+    int generations;
+    uint64_t evaluations;
+    double seconds;
+};
+
+void PrintUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --algorithms LIST           comma-separated ga,gwo (default ga,gwo)\n"
+              << "  --functions LIST            comma-separated parabola,rastrigin,custom,ackley,griewank\n"
+              << "                              (default parabola,rastrigin,ackley,griewank)\n"
+              << "  --seeds N                   runs per algorithm and function (default 30)\n"
+              << "  --first-seed N              (default 1)\n"
+              << "  --dimensions N              (default 1)\n"
+              << "  --population N              (default 50)\n"
+              << "  --max-generations N         budget per run (default 1000)\n"
+              << "  --epsilon X                 target: best f(x) - optimum <= X (default 1e-3)\n"
+              << "  --threads N                 0 = all cores, 1 = single thread (default 1)\n"
+              << "  --engine xoshiro|pcg64|philox random engine (default xoshiro)\n"
+              << "  --output PREFIX             writes PREFIX_runs.csv, PREFIX_percentiles.csv, PREFIX_ecdf.csv (default ttt)\n"
+              << "GA only:\n"
+              << "  --chromosome N              bits per dimension, 1..64 (default 16)\n"
+              << "  --crossover-rate X          (default 0.8)\n"
+              << "  --mutation-rate X           (default 0.1)\n"
+              << "  --cache                     memoize fitness by genotype\n";
+}
+
+// Індекси назв зі списку через кому; false, якщо якась назва невідома
+template <typename Names>
+bool ParseList(const std::string& value, const Names& names, std::vector<size_t>& out) {
+    out.clear();
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        auto found = std::find_if(std::begin(names), std::end(names), [&](const auto& name) { return item == name; });
+        if (found == std::end(names)) return false;
+        out.push_back(static_cast<size_t>(found - std::begin(names)));
+    }
+    return !out.empty();
+}
+
+bool ParseArguments(int argc, char** argv, HarnessOptions& options) {
+    std::vector<std::string> problemNames;
+    for (const Problem& problem : problems) problemNames.push_back(problem.name);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            std::exit(0);
+        }
+        if (arg == "--cache") {
+            options.fitnessCache = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--algorithms") {
+                std::vector<size_t> indices;
+                if (!ParseList(value, algorithmNames, indices)) throw std::invalid_argument(value);
+                options.algorithms.assign(indices.begin(), indices.end());
+            }
+            else if (arg == "--functions") {
+                if (!ParseList(value, problemNames, options.problems)) throw std::invalid_argument(value);
+            }
+            else if (arg == "--engine") {
+                std::vector<size_t> indices;
+                if (!ParseList(value, engineNames, indices) || indices.size() != 1) throw std::invalid_argument(value);
+                options.engine = static_cast<int>(indices[0]);
+            }
+            else if (arg == "--seeds") options.seeds = std::stoi(value);
+            else if (arg == "--first-seed") options.firstSeed = std::stoull(value);
+            else if (arg == "--dimensions") options.dimensions = std::stoul(value);
+            else if (arg == "--population") options.populationSize = std::stoul(value);
+            else if (arg == "--max-generations") options.maxGenerations = std::stoi(value);
+            else if (arg == "--epsilon") options.epsilon = std::stof(value);
+            else if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--output") options.output = value;
+            else if (arg == "--chromosome") options.chromosomeLength = std::stoul(value);
+            else if (arg == "--crossover-rate") options.crossoverRate = std::stof(value);
+            else if (arg == "--mutation-rate") options.mutationRate = std::stof(value);
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+
+    if (options.seeds < 1 || options.populationSize < 2 || options.dimensions < 1 || options.maxGenerations < 0 || !(options.epsilon >= 0.0f)) {
+        std::cerr << "Seeds must be positive, population at least 2, dimensions positive, generations and epsilon non-negative" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Крутить покоління, доки найкраще значення не досягне target або не скінчиться бюджет.
+// Час рахується з моменту перед initialize, тобто разом з початковою популяцією
+template <typename Optimizer, typename Init, typename Function>
+void RunToTarget(Optimizer& optimizer, Init&& initialize, const Function& function, float target, int maxGenerations, RunResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    initialize(optimizer);
+    result.reached = optimizer.GetEvaluationCount() > 0 && optimizer.GetBestFitness() <= target;
+    while (!result.reached && optimizer.GetCurrentGeneration() < maxGenerations) {
+        optimizer.RunGeneration(function);
+        result.reached = optimizer.GetBestFitness() <= target;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.generations = optimizer.GetCurrentGeneration();
+    result.evaluations = optimizer.GetEvaluationCount();
+}
+
+std::vector<RunResult> RunAll(const HarnessOptions& options, ThreadPool* pool) {
+    std::vector<RunResult> results;
+    WithDimensions(options.dimensions, [&](auto dimensions) {
+        constexpr size_t D = decltype(dimensions)::value;
+        WithRandomEngine(options.engine, [&](auto engine) {
+            using Engine = typename decltype(engine)::type;
+            for (int algorithm : options.algorithms) {
+                for (size_t problemIndex : options.problems) {
+                    const Problem& problem = problems[problemIndex];
+                    std::vector<float> lower(options.dimensions, problem.searchMin);
+                    std::vector<float> upper(options.dimensions, problem.searchMax);
+                    float target = problem.optimum + options.epsilon;
+
+                    WithTestFunction(problem.function, [&](auto function) {
+                        for (int s = 0; s < options.seeds; ++s) {
+                            RunResult result = { algorithm, problemIndex, options.firstSeed + static_cast<uint64_t>(s), false, 0, 0, 0.0 };
+                            if (algorithm == 0) {
+                                GeneticAlgorithm<D, Engine> ga;
+                                RunToTarget(ga, [&](GeneticAlgorithm<D, Engine>& optimizer) {
+                                    optimizer.Initialize(options.populationSize, options.chromosomeLength, lower, upper,
+                                                         options.crossoverRate, options.mutationRate, result.seed);
+                                    optimizer.SetThreadPool(pool);
+                                    optimizer.EnableFitnessCache(options.fitnessCache);
+                                    optimizer.EvaluateFitness(function);
+                                }, function, target, options.maxGenerations, result);
+                            } else {
+                                GreyWolfOptimizer<D, Engine> gwo;
+                                RunToTarget(gwo, [&](GreyWolfOptimizer<D, Engine>& optimizer) {
+                                    optimizer.Initialize(options.populationSize, lower, upper, result.seed);
+                                    optimizer.SetThreadPool(pool);
+                                }, function, target, options.maxGenerations, result);
+                            }
+                            results.push_back(result);
+                        }
+                    });
+                }
+            }
+        });
+    });
+    return results;
+}
+
+// Перцентиль за найближчим рангом; невдалі прогони вважаються нескінченними
+double Percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void PrintValue(FILE* file, double value, const char* format) {
+    if (std::isinf(value)) std::fprintf(file, "inf");
+    else std::fprintf(file, format, value);
+}
+
+FILE* OpenCsv(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) std::cerr << "Cannot write " << path << std::endl;
+    return file;
+}
+
+bool WriteReports(const HarnessOptions& options, const std::vector<RunResult>& results) {
+    const double percentiles[] = { 0.1, 0.25, 0.5, 0.75, 0.9 };
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    FILE* runs = OpenCsv(options.output + "_runs.csv");
+    FILE* table = OpenCsv(options.output + "_percentiles.csv");
+    FILE* ecdf = OpenCsv(options.output + "_ecdf.csv");
+    bool ok = runs && table && ecdf;
+    if (!ok) {
+        for (FILE* file : { runs, table, ecdf }) if (file) std::fclose(file);
+        return false;
+    }
+
+    std::fprintf(runs, "algorithm,engine,function,dimensions,seed,reached,generations,evaluations,seconds\n");
+    for (const RunResult& r : results) {
+        std::fprintf(runs, "%s,%s,%s,%zu,%llu,%d,%d,%llu,%.9f\n", algorithmNames[r.algorithm], engineNames[options.engine],
+                     problems[r.problem].name, options.dimensions,
+                     static_cast<unsigned long long>(r.seed), r.reached ? 1 : 0, r.generations,
+                     static_cast<unsigned long long>(r.evaluations), r.seconds);
+    }
+
+    std::fprintf(table, "algorithm,function,dimensions,runs,success_rate");
+    for (const char* metric : { "evaluations", "seconds" }) {
+        for (double p : percentiles) std::fprintf(table, ",%s_p%d", metric, static_cast<int>(p * 100.0 + 0.5));
+    }
+    std::fprintf(table, "\n");
+    std::fprintf(ecdf, "algorithm,function,dimensions,metric,value,fraction\n");
+
+    std::printf("%-4s %-10s %5s %8s %14s %14s\n", "alg", "function", "runs", "success", "median evals", "median ms");
+    for (int algorithm : options.algorithms) {
+        for (size_t problem : options.problems) {
+            std::vector<double> evaluations, seconds;
+            size_t reached = 0;
+            for (const RunResult& r : results) {
+                if (r.algorithm != algorithm || r.problem != problem) continue;
+                evaluations.push_back(r.reached ? static_cast<double>(r.evaluations) : infinity);
+                seconds.push_back(r.reached ? r.seconds : infinity);
+                reached += r.reached ? 1 : 0;
+            }
+            if (evaluations.empty()) continue;
+            std::sort(evaluations.begin(), evaluations.end());
+            std::sort(seconds.begin(), seconds.end());
+            const char* algorithmName = algorithmNames[algorithm];
+            const char* functionName = problems[problem].name;
+            double successRate = static_cast<double>(reached) / static_cast<double>(evaluations.size());
+
+            std::fprintf(table, "%s,%s,%zu,%zu,%.4f", algorithmName, functionName, options.dimensions, evaluations.size(), successRate);
+            for (double p : percentiles) {
+                std::fprintf(table, ",");
+                PrintValue(table, Percentile(evaluations, p), "%.0f");
+            }
+            for (double p : percentiles) {
+                std::fprintf(table, ",");
+                PrintValue(table, Percentile(seconds, p), "%.9f");
+            }
+            std::fprintf(table, "\n");
+
+            // Частка прогонів, що досягли цілі не пізніше за value; невдалі прогони сходинок не дають
+            for (size_t i = 0; i < reached; ++i) {
+                double fraction = static_cast<double>(i + 1) / static_cast<double>(evaluations.size());
+                std::fprintf(ecdf, "%s,%s,%zu,evaluations,%.0f,%.6f\n", algorithmName, functionName, options.dimensions, evaluations[i], fraction);
+            }
+            for (size_t i = 0; i < reached; ++i) {
+                double fraction = static_cast<double>(i + 1) / static_cast<double>(seconds.size());
+                std::fprintf(ecdf, "%s,%s,%zu,seconds,%.9f,%.6f\n", algorithmName, functionName, options.dimensions, seconds[i], fraction);
+            }
+
+            std::printf("%-4s %-10s %5zu %7.1f%% ", algorithmName, functionName, evaluations.size(), successRate * 100.0);
+            PrintValue(stdout, Percentile(evaluations, 0.5), "%14.0f");
+            std::printf(" ");
+            PrintValue(stdout, Percentile(seconds, 0.5) * 1000.0, "%14.3f");
+            std::printf("\n");
+        }
+    }
+
+    std::fclose(runs);
+    std::fclose(table);
+    std::fclose(ecdf);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    HarnessOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads != 1) {
+        pool = std::make_unique<ThreadPool>(options.threads == 0 ? std::thread::hardware_concurrency() : options.threads);
+    }
+
+    std::vector<RunResult> results = RunAll(options, pool.get());
+    return WriteReports(options, results) ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Simd.cpp"
+
+class ThreadPool;
+
+// Кількість вимірів як параметр шаблону оптимізатора: число - фіксована вимірність,
+// DynamicDimensions - задається в Initialize
+inline constexpr size_t DynamicDimensions = std::dynamic_extent;
+
+// Розмір масиву, що залежить від вимірності: dimensions * multiplier + extra, або DynamicDimensions
+constexpr size_t ScaledExtent(size_t dimensions, size_t multiplier, size_t extra = 0) {
+    return dimensions == DynamicDimensions ? DynamicDimensions : dimensions * multiplier + extra;
+}
+
+// Масив розміру Extent усередині об'єкта, або вирівняний масив у купі, якщо розмір відомий лише під час виконання
+template <typename T, size_t Extent>
+using ExtentArray = std::conditional_t<Extent == DynamicDimensions, AlignedVector<T>, std::array<T, Extent>>;
+
+template <typename T>
+void ResizeExtent(AlignedVector<T>& array, size_t size) {
+    array.resize(size);
+}
+
+// Масив фіксованого розміру не змінюється; невідповідність перевіряється й у release-збірці
+template <typename T, size_t Extent>
+void ResizeExtent(std::array<T, Extent>&, size_t size) {
+    if (size != Extent) throw std::length_error("size does not match the compile-time dimension count");
+}
+
+// Вибір інстанціювання за вимірністю, відомою лише під час виконання: малі вимірності отримують
+// власні фіксовані версії, решта - DynamicDimensions. fn отримує std::integral_constant<size_t, D>
+template <typename Fn>
+void WithDimensions(size_t dimensions, Fn&& fn) {
+    switch (dimensions) {
+        case 1: fn(std::integral_constant<size_t, 1>{}); break;
+        case 2: fn(std::integral_constant<size_t, 2>{}); break;
+        case 3: fn(std::integral_constant<size_t, 3>{}); break;
+        case 4: fn(std::integral_constant<size_t, 4>{}); break;
+        case 8: fn(std::integral_constant<size_t, 8>{}); break;
+        case 16: fn(std::integral_constant<size_t, 16>{}); break;
+        default: fn(std::integral_constant<size_t, DynamicDimensions>{}); break;
+    }
+}
+
+// Спільна основа GA і GWO: кількість вимірів (константа для фіксованої вимірності, тож компілятор
+// розгортає цикли по вимірах) і пул потоків (nullptr - послідовне виконання)
+template <size_t Dimensions>
+class DimensionedOptimizer {
+protected:
+    size_t dimensions = Dimensions == DynamicDimensions ? 1 : Dimensions;
+    ThreadPool* threadPool = nullptr;
+
+    size_t Dims() const {
+        if constexpr (Dimensions != DynamicDimensions) return Dimensions;
+        else return dimensions;
+    }
+
+    // Кількість вимірів береться з довжини меж. Перевірка не лише assert: у release-збірці
+    // Initialize інакше читав би межі й писав масиви фіксованої вимірності за їхнім кінцем
+    void SetDimensions(std::span<const float> lower, std::span<const float> upper) {
+        if (lower.empty() || lower.size() != upper.size() || (Dimensions != DynamicDimensions && lower.size() != Dimensions)) {
+            throw std::invalid_argument("bounds do not match the optimizer's dimension count");
+        }
+        dimensions = lower.size();
+    }
+
+    // Однакова межа в кожному вимірі; з динамічною вимірністю - одновимірний пошук
+    static std::vector<float> UniformBounds(float value) {
+        return std::vector<float>(Dimensions == DynamicDimensions ? 1 : Dimensions, value);
+    }
+
+public:
+    void SetThreadPool(ThreadPool* pool) { threadPool = pool; }
+    size_t GetDimensions() const { return Dims(); }
+};
+
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <cstdio>
 #include "imgui.h"
+#include "Profiler.cpp"
 
 class FunctionDrawer {
 private:
@@ -35,6 +36,8 @@ public:
         }
     }
 
+    int GetResolution() const { return resolution; }
+
     float MapXToScreen(float x, const ImVec2& canvasPos, const ImVec2& canvasSize) {
         return canvasPos.x + (x - searchMin) / (searchMax - searchMin) * canvasSize.x;
     }
@@ -44,6 +47,7 @@ public:
     }
 
     void DrawFunction() {
+        PROFILE_SCOPE(ProfilePhase::FrameDrawFunction);
         ImVec2 canvasPos = ImGui::GetCursorScreenPos();
         ImVec2 canvasSize = ImGui::GetContentRegionAvail();
         
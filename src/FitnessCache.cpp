@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct FitnessCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    double HitRate() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// Кеш fitness за упакованим генотипом (words слів по bitsPerWord значущих біт).
+// Короткі генотипи (до DirectBits біт разом) індексують таблицю напряму, без колізій.
+// Довші йдуть у хеш-таблицю фіксованої ємності з одним слотом на хеш: новий генотип витісняє старий,
+// тож пам'ять обмежена (MaxKeyBytes на ключі за будь-якої довжини генотипу), а повний ключ у слоті
+// відсіює хибні збіги.
+// Lookup лише читає і безпечний з кількох потоків, поки ніхто не викликає Store
+class FitnessCache {
+private:
+    using Word = uint64_t;
+    static constexpr size_t DirectBits = 20;
+    static constexpr size_t MaxHashedSlots = size_t(1) << 20;
+    static constexpr size_t MaxKeyBytes = size_t(64) << 20;
+
+    size_t words;
+    size_t bitsPerWord;
+    bool direct;
+    size_t slotMask;
+    std::vector<Word> keys;     // лише для хеш-таблиці: slots x words
+    std::vector<float> values;  // NaN - порожній слот
+
+    static float Empty() { return std::numeric_limits<float>::quiet_NaN(); }
+
+    size_t DirectIndex(const Word* genome) const {
+        size_t index = 0;
+        for (size_t w = 0; w < words; ++w) {
+            index |= static_cast<size_t>(genome[w]) << (w * bitsPerWord);
+        }
+        return index;
+    }
+
+    size_t HashedSlot(const Word* genome) const {
+        uint64_t hash = 0x9E3779B97F4A7C15ull;
+        for (size_t w = 0; w < words; ++w) {
+            hash = (hash ^ genome[w]) * 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31;
+        }
+        return static_cast<size_t>(hash) & slotMask;
+    }
+
+public:
+    FitnessCache() : words(0), bitsPerWord(0), direct(true), slotMask(0) {}
+
+    // populationSize задає ємність хеш-таблиці: кілька поколінь популяції, але не більше MaxHashedSlots
+    // і не більше, ніж уміщається ключів у MaxKeyBytes
+    void Configure(size_t genomeWords, size_t bits, size_t populationSize) {
+        words = genomeWords;
+        bitsPerWord = bits;
+        direct = words * bitsPerWord <= DirectBits;
+        if (direct) {
+            keys.clear();
+            values.assign(size_t(1) << (words * bitsPerWord), Empty());
+        } else {
+            size_t maxSlots = std::min(MaxHashedSlots, std::max<size_t>(MaxKeyBytes / (words * sizeof(Word)), 1));
+            size_t slots = 1;
+            while (slots < 4 * populationSize && 2 * slots <= maxSlots) slots <<= 1;
+            slotMask = slots - 1;
+            keys.assign(slots * words, 0);
+            values.assign(slots, Empty());
+        }
+    }
+
+    void Clear() {
+        std::fill(values.begin(), values.end(), Empty());
+    }
+
+    bool Lookup(const Word* genome, float& fitness) const {
+        if (values.empty()) return false;
+        size_t slot = direct ? DirectIndex(genome) : HashedSlot(genome);
+        float value = values[slot];
+        if (std::isnan(value)) return false;
+        if (!direct && !std::equal(genome, genome + words, keys.data() + slot * words)) return false;
+        fitness = value;
+        return true;
+    }
+
+    void Store(const Word* genome, float fitness) {
+        if (values.empty()) return;
+        size_t slot = direct ? DirectIndex(genome) : HashedSlot(genome);
+        if (!direct) std::copy_n(genome, words, keys.data() + slot * words);
+        values[slot] = fitness;
+    }
+};
+
+// Адреса, унікальна для кожного типу цільової функції: кеш скидається, коли тип змінюється
+template <typename Objective>
+const void* ObjectiveTag() {
+    static const char tag = 0;
+    return &tag;
+}
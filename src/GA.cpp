@@ -1,138 +1,428 @@
 #include <vector>
 #include <random>
 #include <algorithm>
-#include <functional>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <span>
+#include <limits>
+#include "ThreadPool.cpp"
+#include "Objective.cpp"
+#include "Dimensions.cpp"
+#include "Random.cpp"
+#include "FitnessCache.cpp"
+#include "Profiler.cpp"
+#include "Telemetry.cpp"
 
-class GeneticAlgorithm {
+enum class CrossoverType { SinglePoint, TwoPoint, Uniform };
+
+// Dimensions - кількість змінних, відома під час компіляції (масштаби декодування тоді лежать усередині об'єкта,
+// а цикли по змінних розгортаються), або DynamicDimensions.
+// Engine - генератор випадкових чисел (xoshiro256++, PCG64, Philox4x32 або інший RandomEngine)
+template <size_t Dimensions = DynamicDimensions, RandomEngine Engine = Xoshiro256PlusPlus>
+class GeneticAlgorithm : public DimensionedOptimizer<Dimensions> {
 private:
-    struct Chromosome {
-        std::vector<bool> genes;
-        float fitness;
-        float position;
-        
-        Chromosome(size_t length) : genes(length), fitness(0.0f), position(0.0f) {}
+    using Word = uint64_t;
+    using Rng = Engine;
+    static constexpr size_t WordBits = 64;
+    // Нащадки генеруються шматками фіксованого розміру, кожен зі своїм потоком RNG,
+    // тому результат не залежить від кількості робочих потоків
+    static constexpr size_t OffspringChunk = 64;
+
+    // Популяція зберігається суцільно: геном особини i займає слова [i * D, (i + 1) * D),
+    // змінна d кодується словом d, ген j слова - це біт j.
+    // Позиції - матриця count x D у тому ж порядку рядків
+    struct Population {
+        std::vector<Word> genes;
+        std::vector<float> fitness;
+        std::vector<float> position;
+
+        void Resize(size_t count, size_t words) {
+            genes.assign(count * words, 0);
+            fitness.assign(count, 0.0f);
+            position.assign(count * words, 0.0f);
+        }
     };
 
-    std::vector<Chromosome> population;
+    // Подвійний буфер: нащадки пишуться в offspring, після чого буфери міняються місцями
+    Population population;
+    Population offspring;
+    std::vector<size_t> parentIndices;
     size_t populationSize;
+    size_t tournamentSize;
     size_t chromosomeLength;
+    Word geneMask;
+    bool grayCoding;
+    // Масштаб і зсув декодування окремо для кожного виміру
+    ExtentArray<double, Dimensions> decodeScale, decodeOffset;
+    CrossoverType crossoverType;
     float crossoverRate;
     float mutationRate;
-    float searchMin, searchMax;
+    double mutationSkipScale;
     int currentGeneration;
-    std::mt19937 rng;
+    uint64_t evaluationCount; // виклики цільової функції з моменту Initialize
+    GenerationTelemetry telemetry;
+    // Необов'язковий кеш fitness за генотипом і буфери промахів: кожен шматок пише у власний діапазон
+    // індексів, тож промахи оцінюються пакетно без синхронізації
+    bool cacheEnabled;
+    FitnessCache cache;
+    const void* cacheObjective;
+    FitnessCacheStats cacheStats;
+    std::vector<size_t> missIndices;
+    std::vector<float> missPositions;
+    std::vector<float> missFitness;
+    std::vector<size_t> chunkMisses;
+    Rng rng;
+    std::vector<Rng> streams;
 
-public:
-    GeneticAlgorithm() : populationSize(0), chromosomeLength(0), currentGeneration(0) {
-        rng.seed(std::random_device{}());
+    using DimensionedOptimizer<Dimensions>::Dims;
+    using DimensionedOptimizer<Dimensions>::threadPool;
+
+    Word* Genes(Population& pop, size_t index) { return pop.genes.data() + index * Dims(); }
+    const Word* Genes(const Population& pop, size_t index) const { return pop.genes.data() + index * Dims(); }
+
+    Word RandomWord(Rng& gen) {
+        return gen() & geneMask;
     }
 
-    void Initialize(size_t popSize, size_t chromLength, float min, float max, float crossRate, float mutRate) {
-        populationSize = popSize;
-        chromosomeLength = chromLength;
-        searchMin = min;
-        searchMax = max;
-        crossoverRate = crossRate;
-        mutationRate = mutRate;
-        currentGeneration = 0;
+    // Кількість незмінених генів до наступної мутації: геометричний розподіл з p = mutationRate
+    double MutationGap(Rng& gen) {
+        double u = (static_cast<double>(gen() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+        return std::floor(std::log(u) * mutationSkipScale);
+    }
+
+    // Маска перших `point` генів геному у слові w
+    Word PrefixMask(size_t w, size_t point) const {
+        size_t wordStart = w * chromosomeLength;
+        size_t bits = std::min(point - std::min(point, wordStart), chromosomeLength);
+        return (bits < WordBits) ? (Word(1) << bits) - 1 : ~Word(0);
+    }
+
+    // Біти, що стоять у масці, дитина отримує від parent1, решту - від parent2
+    template <typename MaskFn>
+    void BlendWords(const Word* parent1, const Word* parent2, Word* child, MaskFn mask) {
+        for (size_t w = 0; w < Dims(); ++w) {
+            Word m = mask(w);
+            child[w] = (parent1[w] & m) | (parent2[w] & ~m);
+        }
+    }
+
+    static Word GrayToBinary(Word gray) {
+        gray ^= gray >> 1;
+        gray ^= gray >> 2;
+        gray ^= gray >> 4;
+        gray ^= gray >> 8;
+        gray ^= gray >> 16;
+        gray ^= gray >> 32;
+        return gray;
+    }
 
-        population.clear();
-        for (size_t i = 0; i < populationSize; ++i) {
-            Chromosome chrom(chromosomeLength);
-            for (size_t j = 0; j < chromosomeLength; ++j) {
-                chrom.genes[j] = std::uniform_real_distribution<float>(0, 1)(rng) > 0.5f;
+    // Декодує геноми [begin, end) у суцільну матрицю позицій одним проходом;
+    // внутрішній цикл іде вздовж рядка по суцільних масивах слів, масштабів і зсувів
+    void DecodePositions(Population& pop, size_t begin, size_t end) const {
+        const double* scale = decodeScale.data();
+        const double* offset = decodeOffset.data();
+        for (size_t i = begin; i < end; ++i) {
+            const Word* genes = pop.genes.data() + i * Dims();
+            float* row = pop.position.data() + i * Dims();
+            if (grayCoding) {
+                for (size_t d = 0; d < Dims(); ++d) {
+                    row[d] = static_cast<float>(static_cast<double>(GrayToBinary(genes[d])) * scale[d] + offset[d]);
+                }
+            } else {
+                for (size_t d = 0; d < Dims(); ++d) {
+                    row[d] = static_cast<float>(static_cast<double>(genes[d]) * scale[d] + offset[d]);
+                }
             }
-            population.push_back(chrom);
         }
     }
 
-    float BinaryToFloat(const std::vector<bool>& binary) {
-        unsigned long long decimal = 0;
-        for (size_t i = 0; i < chromosomeLength; ++i) {
-            decimal = (decimal << 1) | (binary[i] ? 1 : 0);
+    size_t TournamentSelection(size_t size, Rng& gen) {
+        size_t best = UniformIndex(gen, populationSize);
+        for (size_t i = 1; i < size; ++i) {
+            size_t candidate = UniformIndex(gen, populationSize);
+            if (population.fitness[candidate] > population.fitness[best]) {
+                best = candidate;
+            }
         }
-        double maxDecimal = (1ULL << chromosomeLength) - 1;
-        return static_cast<float>((decimal / maxDecimal) * (searchMax - searchMin) + searchMin);
+        return best;
     }
 
-    void EvaluateFitness(std::function<float(float)> fitnessFunction) {
-        for (auto& chrom : population) {
-            chrom.position = BinaryToFloat(chrom.genes);
-            chrom.fitness = -fitnessFunction(chrom.position); 
+    template <typename Objective>
+    void EvaluateRange(Population& pop, size_t begin, size_t end, const Objective& objective) {
+        if (cacheEnabled) {
+            EvaluateRangeCached(pop, begin, end, objective);
+            return;
         }
+        evaluationCount += end - begin;
+        ParallelFor(threadPool, end - begin, BalancedGrain(threadPool, end - begin), [&](size_t first, size_t last, size_t) {
+            PROFILE_SCOPE(ProfilePhase::GaEvaluation);
+            std::span<float> fitness(pop.fitness.data() + begin + first, last - first);
+            EvaluateBatch<Dimensions>(objective, std::span<const float>(pop.position.data() + (begin + first) * Dims(), (last - first) * Dims()), fitness);
+            for (float& value : fitness) {
+                value = -value;
+            }
+        });
     }
 
-    std::vector<bool> Crossover(const std::vector<bool>& parent1, const std::vector<bool>& parent2) {
-        std::vector<bool> child(chromosomeLength);
-        if (std::uniform_real_distribution<float>(0, 1)(rng) < crossoverRate) {
-            size_t crossoverPoint = std::uniform_int_distribution<size_t>(1, chromosomeLength - 1)(rng);
-            for (size_t i = 0; i < chromosomeLength; ++i) {
-                child[i] = (i < crossoverPoint) ? parent1[i] : parent2[i];
+    // Влучання беруть fitness із кешу, промахи збираються в суцільний буфер і оцінюються одним пакетом.
+    // Нові значення записуються в кеш послідовно після паралельної частини
+    template <typename Objective>
+    void EvaluateRangeCached(Population& pop, size_t begin, size_t end, const Objective& objective) {
+        if (cacheObjective != ObjectiveTag<Objective>()) {
+            cache.Clear();
+            cacheObjective = ObjectiveTag<Objective>();
+        }
+
+        size_t grain = BalancedGrain(threadPool, end - begin);
+        chunkMisses.assign((end - begin + grain - 1) / grain, 0);
+        ParallelFor(threadPool, end - begin, grain, [&](size_t first, size_t last, size_t chunk) {
+            PROFILE_SCOPE(ProfilePhase::GaEvaluation);
+            size_t misses = 0;
+            for (size_t i = begin + first; i < begin + last; ++i) {
+                if (cache.Lookup(Genes(pop, i), pop.fitness[i])) continue;
+                missIndices[first + misses] = i;
+                std::copy_n(pop.position.data() + i * Dims(), Dims(), missPositions.data() + (first + misses) * Dims());
+                ++misses;
             }
+            chunkMisses[chunk] = misses;
+            if (misses == 0) return;
+
+            std::span<float> fitness(missFitness.data() + first, misses);
+            EvaluateBatch<Dimensions>(objective, std::span<const float>(missPositions.data() + first * Dims(), misses * Dims()), fitness);
+            for (size_t k = 0; k < misses; ++k) {
+                pop.fitness[missIndices[first + k]] = -fitness[k];
+            }
+        });
+
+        PROFILE_SCOPE(ProfilePhase::GaEvaluation);
+        size_t totalMisses = 0;
+        for (size_t chunk = 0; chunk < chunkMisses.size(); ++chunk) {
+            size_t first = chunk * grain;
+            for (size_t k = 0; k < chunkMisses[chunk]; ++k) {
+                size_t i = missIndices[first + k];
+                cache.Store(Genes(pop, i), pop.fitness[i]);
+            }
+            totalMisses += chunkMisses[chunk];
+        }
+        cacheStats.misses += totalMisses;
+        evaluationCount += totalMisses;
+        cacheStats.hits += (end - begin) - totalMisses;
+    }
+
+    void ConfigureCache() {
+        cache.Configure(Dims(), chromosomeLength, populationSize);
+        cacheObjective = nullptr;
+        missIndices.resize(populationSize);
+        missPositions.resize(populationSize * Dims());
+        missFitness.resize(populationSize);
+    }
+
+    size_t BestIndex() const {
+        return std::max_element(population.fitness.begin(), population.fitness.end()) - population.fitness.begin();
+    }
+
+    void RecordTelemetry() {
+        telemetry.Record(currentGeneration, population.fitness, population.position.data(), Dims(), evaluationCount);
+    }
+
+public:
+    GeneticAlgorithm()
+        : populationSize(0), tournamentSize(3), chromosomeLength(0), geneMask(0), grayCoding(false),
+                         crossoverType(CrossoverType::SinglePoint), currentGeneration(0), evaluationCount(0),
+                         cacheEnabled(false), cacheObjective(nullptr), rng(0, 0) {
+    }
+
+    // Межі по вимірах, chromLength - біт на вимір.
+    // Уся випадковість запуску походить від seed: той самий seed і ті самі параметри дають
+    // ту саму послідовність поколінь, з пулом потоків чи без (див. RunGeneration)
+    void Initialize(size_t popSize, size_t chromLength, std::span<const float> lower, std::span<const float> upper,
+                    float crossRate, float mutRate, uint64_t seed,
+                    CrossoverType crossType = CrossoverType::SinglePoint, bool gray = false, size_t tournament = 3) {
+        this->SetDimensions(lower, upper); // до будь-яких змін стану: при невідповідних межах кидає виняток
+        rng = Rng(seed, 0);
+        populationSize = popSize;
+        tournamentSize = std::max<size_t>(tournament, 1);
+        // Одне слово на змінну: довше 64 біт float все одно не розрізнить
+        chromosomeLength = std::clamp<size_t>(chromLength, 1, WordBits);
+        geneMask = (chromosomeLength == WordBits) ? ~Word(0) : (Word(1) << chromosomeLength) - 1;
+        grayCoding = gray;
+        ResizeExtent(decodeScale, Dims());
+        ResizeExtent(decodeOffset, Dims());
+        for (size_t d = 0; d < Dims(); ++d) {
+            decodeScale[d] = (static_cast<double>(upper[d]) - lower[d]) / static_cast<double>(geneMask);
+            decodeOffset[d] = lower[d];
+        }
+        crossoverType = crossType;
+        crossoverRate = crossRate;
+        mutationRate = mutRate;
+        mutationSkipScale = (mutationRate > 0.0f) ? 1.0 / std::log1p(-std::min(static_cast<double>(mutationRate), 1.0)) : 0.0;
+        currentGeneration = 0;
+        evaluationCount = 0;
+        telemetry.Clear();
+
+        population.Resize(populationSize, Dims());
+        offspring.Resize(populationSize, Dims());
+        // По два батьки на кожного нащадка, крім еліти
+        parentIndices.assign(populationSize > 1 ? 2 * (populationSize - 1) : 0, 0);
+        for (Word& word : population.genes) {
+            word = RandomWord(rng);
+        }
+
+        SeedChunkStreams(streams, rng, populationSize > 1 ? (populationSize - 2) / OffspringChunk + 1 : 0);
+
+        if (cacheEnabled) ConfigureCache();
+        cacheStats = FitnessCacheStats();
+    }
+
+    // Однакові межі [min, max] у кожному вимірі
+    void Initialize(size_t popSize, size_t chromLength, float min, float max, float crossRate, float mutRate, uint64_t seed,
+                    CrossoverType crossType = CrossoverType::SinglePoint, bool gray = false, size_t tournament = 3) {
+        Initialize(popSize, chromLength, this->UniformBounds(min), this->UniformBounds(max), crossRate, mutRate, seed, crossType, gray, tournament);
+    }
+
+    // Кеш не змінює траєкторію: влучання повертає те саме значення, яке дало б повторне оцінювання.
+    // Для цільових функцій зі станом кеш треба скидати вручну, автоматично він скидається лише зі зміною типу
+    void EnableFitnessCache(bool enabled) {
+        cacheEnabled = enabled;
+        if (cacheEnabled) {
+            ConfigureCache();
         } else {
-            child = parent1;
+            cache = FitnessCache();
         }
-        return child;
     }
 
-    void Mutate(std::vector<bool>& chromosome) {
-        for (size_t i = 0; i < chromosomeLength; ++i) {
-            if (std::uniform_real_distribution<float>(0, 1)(rng) < mutationRate) {
-                chromosome[i] = !chromosome[i];
+    void ClearFitnessCache() { cache.Clear(); }
+    bool IsFitnessCacheEnabled() const { return cacheEnabled; }
+    FitnessCacheStats GetFitnessCacheStats() const { return cacheStats; }
+
+    // Значення змінної dimension, закодованої в геномі
+    float BinaryToFloat(const Word* chromosome, size_t dimension = 0) const {
+        Word value = grayCoding ? GrayToBinary(chromosome[dimension]) : chromosome[dimension];
+        return static_cast<float>(static_cast<double>(value) * decodeScale[dimension] + decodeOffset[dimension]);
+    }
+
+    template <typename Objective>
+    void EvaluateFitness(const Objective& objective) {
+        DecodePositions(population, 0, populationSize);
+        EvaluateRange(population, 0, populationSize, objective);
+        RecordTelemetry();
+    }
+
+    void Crossover(const Word* parent1, const Word* parent2, Word* child) { Crossover(parent1, parent2, child, rng); }
+
+    void Crossover(const Word* parent1, const Word* parent2, Word* child, Rng& gen) {
+        size_t totalBits = Dims() * chromosomeLength;
+        if (totalBits < 2 || UnitFloat(static_cast<uint32_t>(gen() >> 32)) >= crossoverRate) {
+            std::copy(parent1, parent1 + Dims(), child);
+            return;
+        }
+
+        switch (crossoverType) {
+            case CrossoverType::SinglePoint: {
+                size_t point = 1 + UniformIndex(gen, totalBits - 1);
+                BlendWords(parent1, parent2, child, [&](size_t w) { return PrefixMask(w, point); });
+                break;
             }
+            case CrossoverType::TwoPoint: {
+                // Відрізок [first, second) береться від parent2
+                size_t first = 1 + UniformIndex(gen, totalBits - 1);
+                size_t second = 1 + UniformIndex(gen, totalBits - 1);
+                if (first > second) std::swap(first, second);
+                BlendWords(parent1, parent2, child, [&](size_t w) { return ~(PrefixMask(w, second) & ~PrefixMask(w, first)); });
+                break;
+            }
+            case CrossoverType::Uniform:
+                BlendWords(parent1, parent2, child, [&](size_t) { return RandomWord(gen); });
+                break;
         }
     }
 
-    Chromosome TournamentSelection() {
-        int tournamentSize = 3;
-        Chromosome* best = &population[std::uniform_int_distribution<int>(0, populationSize - 1)(rng)];
-        
-        for (int i = 1; i < tournamentSize; ++i) {
-            Chromosome* candidate = &population[std::uniform_int_distribution<int>(0, populationSize - 1)(rng)];
-            if (candidate->fitness > best->fitness) { 
-                best = candidate;
-            }
+    void Mutate(Word* chromosome) { Mutate(chromosome, rng); }
+
+    void Mutate(Word* chromosome, Rng& gen) {
+        if (mutationRate <= 0.0f) return;
+
+        // Один виклик RNG на кожну мутацію замість одного на кожен ген
+        size_t totalBits = Dims() * chromosomeLength;
+        for (double bit = MutationGap(gen); bit < static_cast<double>(totalBits); bit += MutationGap(gen) + 1.0) {
+            size_t index = static_cast<size_t>(bit);
+            chromosome[index / chromosomeLength] ^= Word(1) << (index % chromosomeLength);
         }
-        return *best;
-    }
-
-    void RunGeneration(std::function<float(float)> fitnessFunction) {
-        std::vector<Chromosome> newPopulation;
-        
-        auto bestChromosome = *std::max_element(population.begin(), population.end(),
-            [](const Chromosome& a, const Chromosome& b) { return a.fitness < b.fitness; });
-        newPopulation.push_back(bestChromosome);
-
-        while (newPopulation.size() < populationSize) {
-            Chromosome parent1 = TournamentSelection();
-            Chromosome parent2 = TournamentSelection();
-            
-            Chromosome child1(chromosomeLength);
-            child1.genes = Crossover(parent1.genes, parent2.genes);
-            Mutate(child1.genes);
-            
-            child1.position = BinaryToFloat(child1.genes);
-            child1.fitness = -fitnessFunction(child1.position);
-            
-            newPopulation.push_back(child1);
+    }
+
+    size_t TournamentSelection(size_t size) {
+        return TournamentSelection(size, rng);
+    }
+
+    // Проводить count турнірів за один прохід і записує індекси переможців у out
+    void SelectParents(size_t* out, size_t count, size_t size) { SelectParents(out, count, size, rng); }
+
+    void SelectParents(size_t* out, size_t count, size_t size, Rng& gen) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = TournamentSelection(size, gen);
         }
+    }
+
+    template <typename Objective>
+    void RunGeneration(const Objective& objective) {
+        TRACE_SCOPE("GA generation");
+        size_t bestIndex = BestIndex();
+        std::copy_n(Genes(population, bestIndex), Dims(), Genes(offspring, 0));
+        std::copy_n(population.position.data() + bestIndex * Dims(), Dims(), offspring.position.data());
+        offspring.fitness[0] = population.fitness[bestIndex];
 
-        population = newPopulation;
+        // Спершу генеруємо всіх нащадків, потім оцінюємо їх окремим проходом.
+        // Межі шматків і їхні потоки RNG фіксовані, тож кількість потоків на результат не впливає.
+        // Кожна фаза проходить по всьому шматку окремо, тож її можна заміряти одним таймером
+        ParallelFor(threadPool, populationSize - 1, OffspringChunk, [&](size_t begin, size_t end, size_t chunk) {
+            Rng& gen = streams[chunk];
+            size_t* parents = parentIndices.data() + 2 * begin;
+            {
+                PROFILE_SCOPE(ProfilePhase::GaSelection);
+                SelectParents(parents, 2 * (end - begin), tournamentSize, gen);
+            }
+            {
+                PROFILE_SCOPE(ProfilePhase::GaCrossover);
+                for (size_t i = begin; i < end; ++i) {
+                    const Word* parent1 = Genes(population, parents[2 * (i - begin)]);
+                    const Word* parent2 = Genes(population, parents[2 * (i - begin) + 1]);
+                    Crossover(parent1, parent2, Genes(offspring, i + 1), gen);
+                }
+            }
+            {
+                PROFILE_SCOPE(ProfilePhase::GaMutation);
+                for (size_t i = begin; i < end; ++i) {
+                    Mutate(Genes(offspring, i + 1), gen);
+                }
+            }
+            PROFILE_SCOPE(ProfilePhase::GaDecoding);
+            DecodePositions(offspring, begin + 1, end + 1);
+        });
+
+        EvaluateRange(offspring, 1, populationSize, objective);
+
+        std::swap(population, offspring);
         currentGeneration++;
+        RecordTelemetry();
+        PROFILE_COMMIT(ProfileGroup::Optimizer);
     }
 
-    std::vector<float> GetBestPositions() {
-        std::vector<float> positions;
-        if (population.empty()) return positions;
-        
-        auto best = std::max_element(population.begin(), population.end(),
-            [](const Chromosome& a, const Chromosome& b) { return a.fitness < b.fitness; });
-        
-        if (best != population.end()) {
-            positions.push_back(best->position);
-        }
-        return positions;
-    } 
+    // Позиція найкращої особини, dimensions координат; дійсна до наступного покоління
+    std::span<const float> GetBestPositions() const {
+        if (populationSize == 0) return {};
+        return { population.position.data() + BestIndex() * Dims(), Dims() };
+    }
+
+    // Значення цільової функції в найкращій особині (без зворотного знака)
+    float GetBestFitness() const {
+        return populationSize > 0 ? -population.fitness[BestIndex()] : std::numeric_limits<float>::max();
+    }
+
+    uint64_t GetEvaluationCount() const { return evaluationCount; }
+    // Підсумки поколінь, включно з початковою популяцією; читати можна й під час роботи оптимізатора
+    const TelemetryRing& GetTelemetry() const { return telemetry.Ring(); }
+    void EnableTelemetry(bool enabled) { telemetry.SetEnabled(enabled); }
 
     int GetCurrentGeneration() const { return currentGeneration; }
 };
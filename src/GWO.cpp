@@ -1,106 +1,272 @@
 #include <vector>
 #include <random>
 #include <algorithm>
-#include <functional>
 #include <cmath>
 #include <limits>
+#include <span>
+#include <cassert>
+#include "ThreadPool.cpp"
+#include "Objective.cpp"
+#include "Dimensions.cpp"
+#include "Simd.cpp"
+#include "Random.cpp"
+#include "Profiler.cpp"
+#include "Telemetry.cpp"
 
-class GreyWolfOptimizer {
+// Крок GWO для n координат, що лежать підряд. Координата k рухається до alpha[k], beta[k], delta[k]
+// і обрізається до [lower[k], upper[k]]; масиви лідерів і меж вже розкладені під ті самі k.
+// r - шість суцільних масивів по n чисел із [0, 1): (A, C) для alpha, beta і delta.
+// Усі ядра виконують ті самі операції без FMA (AVX2-ядро зібране без fma у цілі, тож компілятор
+// не зливає множення з додаванням), тому результат не залежить від набору інструкцій
+struct WolfUpdateParams {
+    float a;
+    const float* alpha;
+    const float* beta;
+    const float* delta;
+    const float* lower;
+    const float* upper;
+};
+
+// first - з якої координати почати (хвіст після SIMD-циклу)
+inline void UpdateWolvesScalar(float* positions, size_t n, const float* r, const WolfUpdateParams& p, size_t first = 0) {
+    const float twoA = 2.0f * p.a;
+    for (size_t i = first; i < n; ++i) {
+        float position = positions[i];
+        float X1 = p.alpha[i] - (twoA * r[i] - p.a) * std::abs(2.0f * r[n + i] * p.alpha[i] - position);
+        float X2 = p.beta[i] - (twoA * r[2 * n + i] - p.a) * std::abs(2.0f * r[3 * n + i] * p.beta[i] - position);
+        float X3 = p.delta[i] - (twoA * r[4 * n + i] - p.a) * std::abs(2.0f * r[5 * n + i] * p.delta[i] - position);
+        float newPosition = (X1 + X2 + X3) / 3.0f;
+        positions[i] = std::max(p.lower[i], std::min(p.upper[i], newPosition));
+    }
+}
+
+#if SIMD_X86
+SIMD_TARGET_AVX2_NO_FMA inline __m256 WolfTermAvx2(__m256 leader, __m256 position, __m256 rA, __m256 rC, __m256 twoA, __m256 a) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 A = _mm256_sub_ps(_mm256_mul_ps(twoA, rA), a);
+    __m256 C = _mm256_mul_ps(_mm256_set1_ps(2.0f), rC);
+    __m256 D = _mm256_and_ps(_mm256_sub_ps(_mm256_mul_ps(C, leader), position), absMask);
+    return _mm256_sub_ps(leader, _mm256_mul_ps(A, D));
+}
+
+SIMD_TARGET_AVX2_NO_FMA inline void UpdateWolvesAvx2(float* positions, size_t n, const float* r, const WolfUpdateParams& p) {
+    const __m256 a = _mm256_set1_ps(p.a);
+    const __m256 twoA = _mm256_set1_ps(2.0f * p.a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 position = _mm256_loadu_ps(positions + i);
+        __m256 X1 = WolfTermAvx2(_mm256_loadu_ps(p.alpha + i), position, _mm256_loadu_ps(r + i), _mm256_loadu_ps(r + n + i), twoA, a);
+        __m256 X2 = WolfTermAvx2(_mm256_loadu_ps(p.beta + i), position, _mm256_loadu_ps(r + 2 * n + i), _mm256_loadu_ps(r + 3 * n + i), twoA, a);
+        __m256 X3 = WolfTermAvx2(_mm256_loadu_ps(p.delta + i), position, _mm256_loadu_ps(r + 4 * n + i), _mm256_loadu_ps(r + 5 * n + i), twoA, a);
+        __m256 newPosition = _mm256_div_ps(_mm256_add_ps(_mm256_add_ps(X1, X2), X3), _mm256_set1_ps(3.0f));
+        _mm256_storeu_ps(positions + i, _mm256_max_ps(_mm256_loadu_ps(p.lower + i), _mm256_min_ps(_mm256_loadu_ps(p.upper + i), newPosition)));
+    }
+    UpdateWolvesScalar(positions, n, r, p, i);
+}
+#endif
+
+inline void UpdateWolves(float* positions, size_t n, const float* r, const WolfUpdateParams& p) {
+#if SIMD_X86
+    if (GetSimdLevel() >= SimdLevel::Avx2) {
+        UpdateWolvesAvx2(positions, n, r, p);
+        return;
+    }
+#endif
+    UpdateWolvesScalar(positions, n, r, p);
+}
+
+// Dimensions - кількість вимірів, відома під час компіляції (лідери й межі тоді лежать усередині об'єкта,
+// а цикли по вимірах розгортаються), або DynamicDimensions.
+// Engine - генератор випадкових чисел (xoshiro256++, PCG64, Philox4x32 або інший RandomEngine)
+template <size_t Dimensions = DynamicDimensions, RandomEngine Engine = Xoshiro256PlusPlus>
+class GreyWolfOptimizer : public DimensionedOptimizer<Dimensions> {
 private:
-    struct Wolf {
-        float position;
-        float fitness;
-        
-        Wolf() : position(0.0f), fitness(-std::numeric_limits<float>::max()) {}
-        Wolf(float pos, float fit) : position(pos), fitness(fit) {}
+    // Трійка лідерів за індексами у зграї. Вставка стабільна: при рівному fitness перемагає той,
+    // хто прийшов раніше, тому злиття локальних трійок у порядку шматків дає той самий результат,
+    // що й послідовний прохід
+    struct LeaderIndices {
+        size_t index[3];
+        float fitness[3];
+
+        LeaderIndices() : index{ 0, 0, 0 } {
+            std::fill_n(fitness, 3, -std::numeric_limits<float>::max());
+        }
+
+        void Insert(size_t wolf, float value) {
+            size_t rank = 0;
+            while (rank < 3 && !(value > fitness[rank])) ++rank;
+            if (rank == 3) return;
+            for (size_t k = 2; k > rank; --k) {
+                index[k] = index[k - 1];
+                fitness[k] = fitness[k - 1];
+            }
+            index[rank] = wolf;
+            fitness[rank] = value;
+        }
     };
 
-    std::vector<Wolf> wolves;
-    Wolf alpha, beta, delta;
+    // Оновлення позицій іде шматками фіксованого розміру, кожен зі своїм потоком RNG.
+    // Усередині шматка коефіцієнти A і C генеруються блоками по UpdateBlock координат, що вміщаються в L1
+    static constexpr size_t UpdateChunk = 256;
+    static constexpr size_t UpdateBlock = 64;
+
+    // Зграя - матриця populationSize x dimensions у порядку рядків, fitness - окремий вирівняний масив,
+    // тож цикл оновлення і пакетна цільова функція працюють із суцільною пам'яттю
+    AlignedVector<float> positions;
+    AlignedVector<float> fitness;
+    // Рядки alpha, beta, delta підряд; лідери живуть між поколіннями, тому їхні позиції копіюються
+    alignas(64) ExtentArray<float, ScaledExtent(Dimensions, 3)> leaderPositions;
+    float leaderFitness[3];
+    std::vector<LeaderIndices> chunkLeaders;
+    // Рядок, повторений періодично на dimensions + UpdateBlock елементів: блок із будь-якого місця
+    // матриці бачить свої лідери й межі як суцільні масиви, починаючи зі зсуву (початок блоку) % dimensions
+    using Tile = ExtentArray<float, ScaledExtent(Dimensions, 1, UpdateBlock)>;
+    alignas(64) Tile alphaTile, betaTile, deltaTile;
+    alignas(64) Tile lowerTile, upperTile;
     size_t populationSize;
-    float searchMin, searchMax;
     int currentGeneration;
-    std::mt19937 rng;
+    uint64_t evaluationCount; // виклики цільової функції з моменту Initialize
+    GenerationTelemetry telemetry;
+    Engine rng;
+    std::vector<UniformStream<Engine>> streams;
+
+    using DimensionedOptimizer<Dimensions>::Dims;
+    using DimensionedOptimizer<Dimensions>::threadPool;
+
+    const float* Leader(size_t rank) const { return leaderPositions.data() + rank * Dims(); }
+
+    void TileRow(const float* row, Tile& tile) const {
+        for (size_t k = 0; k < tile.size(); ++k) {
+            tile[k] = row[k % Dims()];
+        }
+    }
+
+    void InsertLeader(const float* row, float value) {
+        size_t rank = 0;
+        while (rank < 3 && !(value > leaderFitness[rank])) ++rank;
+        if (rank == 3) return;
+        for (size_t k = 2; k > rank; --k) {
+            std::copy_n(Leader(k - 1), Dims(), leaderPositions.data() + k * Dims());
+            leaderFitness[k] = leaderFitness[k - 1];
+        }
+        std::copy_n(row, Dims(), leaderPositions.data() + rank * Dims());
+        leaderFitness[rank] = value;
+    }
 
 public:
-    GreyWolfOptimizer() : populationSize(0), currentGeneration(0) {
-        rng.seed(std::random_device{}());
+    GreyWolfOptimizer()
+        : leaderPositions{}, leaderFitness{}, populationSize(0), currentGeneration(0), evaluationCount(0), rng(0, 0) {
     }
 
-    void Initialize(size_t popSize, float min, float max) {
+    // Межі по вимірах. Той самий seed дає ту саму зграю і ту саму траєкторію незалежно від пулу потоків
+    void Initialize(size_t popSize, std::span<const float> lower, std::span<const float> upper, uint64_t seed) {
+        this->SetDimensions(lower, upper); // до будь-яких змін стану: при невідповідних межах кидає виняток
+        rng = Engine(seed, 0);
         populationSize = popSize;
-        searchMin = min;
-        searchMax = max;
         currentGeneration = 0;
+        evaluationCount = 0;
+        telemetry.Clear();
 
-        wolves.clear();
-        wolves.resize(populationSize);
-        std::uniform_real_distribution<float> dist(min, max);
-        
-        for (auto& wolf : wolves) {
-            wolf.position = dist(rng);
-            wolf.fitness = -std::numeric_limits<float>::max();
+        positions.resize(populationSize * Dims());
+        fitness.assign(populationSize, -std::numeric_limits<float>::max());
+        // Власне перетворення замість uniform_real_distribution, алгоритм якої залежить від бібліотеки
+        for (size_t k = 0; k < positions.size(); ++k) {
+            size_t d = k % Dims();
+            positions[k] = lower[d] + (upper[d] - lower[d]) * UnitFloat(static_cast<uint32_t>(rng() >> 32));
         }
 
-        alpha = Wolf(0, -std::numeric_limits<float>::max());
-        beta = Wolf(0, -std::numeric_limits<float>::max());
-        delta = Wolf(0, -std::numeric_limits<float>::max());
+        for (Tile* tile : { &alphaTile, &betaTile, &deltaTile, &lowerTile, &upperTile }) {
+            ResizeExtent(*tile, Dims() + UpdateBlock);
+        }
+        TileRow(lower.data(), lowerTile);
+        TileRow(upper.data(), upperTile);
+        ResizeExtent(leaderPositions, 3 * Dims());
+        std::fill(leaderPositions.begin(), leaderPositions.end(), 0.0f);
+        std::fill_n(leaderFitness, 3, -std::numeric_limits<float>::max());
+        SeedChunkStreams(streams, rng, (populationSize + UpdateChunk - 1) / UpdateChunk);
+    }
+
+    // Однакові межі [min, max] у кожному вимірі
+    void Initialize(size_t popSize, float min, float max, uint64_t seed) {
+        Initialize(popSize, this->UniformBounds(min), this->UniformBounds(max), seed);
     }
 
-    void EvaluateFitness(std::function<float(float)> fitnessFunction) {
-        // Оновлюємо alpha, beta, delta
-        for (const auto& wolf : wolves) {
-            float fitness = -fitnessFunction(wolf.position); // Мінімізація
-            
-            if (fitness > alpha.fitness) {
-                delta = beta;
-                beta = alpha;
-                alpha = Wolf(wolf.position, fitness);
-            } 
-            else if (fitness > beta.fitness) {
-                delta = beta;
-                beta = Wolf(wolf.position, fitness);
-            } 
-            else if (fitness > delta.fitness) {
-                delta = Wolf(wolf.position, fitness);
+    template <typename Objective>
+    void EvaluateFitness(const Objective& objective) {
+        size_t grain = BalancedGrain(threadPool, populationSize);
+        chunkLeaders.assign((populationSize + grain - 1) / grain, LeaderIndices());
+        evaluationCount += populationSize;
+
+        // Кожен шматок оцінює своїх вовків і шукає локальних alpha, beta, delta
+        ParallelFor(threadPool, populationSize, grain, [&](size_t begin, size_t end, size_t chunk) {
+            {
+                PROFILE_SCOPE(ProfilePhase::GwoEvaluation);
+                EvaluateBatch<Dimensions>(objective, std::span<const float>(positions.data() + begin * Dims(), (end - begin) * Dims()),
+                                          std::span<float>(fitness.data() + begin, end - begin));
+            }
+
+            PROFILE_SCOPE(ProfilePhase::GwoLeaderUpdate);
+            LeaderIndices& local = chunkLeaders[chunk];
+            for (size_t i = begin; i < end; ++i) {
+                fitness[i] = -fitness[i]; // Мінімізація
+                local.Insert(i, fitness[i]);
+            }
+        });
+
+        // Оновлюємо alpha, beta, delta; рядки копіюються лише для тих, хто потрапив у трійку
+        PROFILE_SCOPE(ProfilePhase::GwoLeaderUpdate);
+        for (const LeaderIndices& local : chunkLeaders) {
+            for (size_t rank = 0; rank < 3; ++rank) {
+                if (local.fitness[rank] == -std::numeric_limits<float>::max()) break;
+                InsertLeader(positions.data() + local.index[rank] * Dims(), local.fitness[rank]);
             }
         }
     }
 
-    void RunGeneration(std::function<float(float)> fitnessFunction) {
-        EvaluateFitness(fitnessFunction);
+    template <typename Objective>
+    void RunGeneration(const Objective& objective) {
+        TRACE_SCOPE("GWO generation");
+        EvaluateFitness(objective);
+        // Позиції ще ті, що щойно оцінені; зграя покоління currentGeneration
+        telemetry.Record(currentGeneration, std::span<const float>(fitness.data(), populationSize), positions.data(), Dims(), evaluationCount);
 
         float a = 2.0f - (2.0f * currentGeneration) / 100.0f;
-        
-        for (auto& wolf : wolves) {
-            float A1 = 2.0f * a * std::uniform_real_distribution<float>(0, 1)(rng) - a;
-            float C1 = 2.0f * std::uniform_real_distribution<float>(0, 1)(rng);
-            float D_alpha = std::abs(C1 * alpha.position - wolf.position);
-            float X1 = alpha.position - A1 * D_alpha;
-
-            float A2 = 2.0f * a * std::uniform_real_distribution<float>(0, 1)(rng) - a;
-            float C2 = 2.0f * std::uniform_real_distribution<float>(0, 1)(rng);
-            float D_beta = std::abs(C2 * beta.position - wolf.position);
-            float X2 = beta.position - A2 * D_beta;
-
-            float A3 = 2.0f * a * std::uniform_real_distribution<float>(0, 1)(rng) - a;
-            float C3 = 2.0f * std::uniform_real_distribution<float>(0, 1)(rng);
-            float D_delta = std::abs(C3 * delta.position - wolf.position);
-            float X3 = delta.position - A3 * D_delta;
-            float newPosition = (X1 + X2 + X3) / 3.0f;
-            wolf.position = std::max(searchMin, std::min(searchMax, newPosition));
+        {
+            PROFILE_SCOPE(ProfilePhase::GwoLeaderUpdate);
+            TileRow(Leader(0), alphaTile);
+            TileRow(Leader(1), betaTile);
+            TileRow(Leader(2), deltaTile);
         }
 
+        // Шматок - UpdateChunk вовків, але всередині нього матриця обробляється як суцільний масив координат
+        ParallelFor(threadPool, populationSize, UpdateChunk, [&](size_t begin, size_t end, size_t chunk) {
+            PROFILE_SCOPE(ProfilePhase::GwoPositionUpdate);
+            UniformStream<Engine>& gen = streams[chunk];
+            alignas(64) float coefficients[6 * UpdateBlock];
+            size_t last = end * Dims();
+            for (size_t block = begin * Dims(); block < last; block += UpdateBlock) {
+                size_t count = std::min(UpdateBlock, last - block);
+                size_t offset = block % Dims();
+                WolfUpdateParams params = { a, alphaTile.data() + offset, betaTile.data() + offset, deltaTile.data() + offset,
+                                            lowerTile.data() + offset, upperTile.data() + offset };
+                gen.Fill(coefficients, 6 * count);
+                UpdateWolves(positions.data() + block, count, coefficients, params);
+            }
+        });
+
         currentGeneration++;
+        PROFILE_COMMIT(ProfileGroup::Optimizer);
     }
 
-    std::vector<float> GetBestPositions() {
-        std::vector<float> positions;
-        positions.push_back(alpha.position);
-        positions.push_back(beta.position);
-        positions.push_back(delta.position);
-        return positions;
-    }
+    // Позиції alpha, beta і delta підряд, по dimensions координат кожна; дійсні до наступного покоління
+    std::span<const float> GetBestPositions() const { return { leaderPositions.data(), leaderPositions.size() }; }
+
+    // Значення цільової функції в alpha (без зворотного знака)
+    float GetBestFitness() const { return -leaderFitness[0]; }
 
+    uint64_t GetEvaluationCount() const { return evaluationCount; }
+    // Підсумки оцінених поколінь; читати можна й під час роботи оптимізатора
+    const TelemetryRing& GetTelemetry() const { return telemetry.Ring(); }
+    void EnableTelemetry(bool enabled) { telemetry.SetEnabled(enabled); }
     int GetCurrentGeneration() const { return currentGeneration; }
 };
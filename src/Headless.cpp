@@ -0,0 +1,277 @@
+// Консольний запуск GA/GWO без вікна, ImGui і vsync: покоління йдуть одне за одним на повній швидкості
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include "ThreadPool.cpp"
+#include "TestFunctions.cpp"
+#include "GA.cpp"
+#include "GWO.cpp"
+
+struct RunOptions {
+    int algorithm = 0; // 0 - GA, 1 - GWO
+    int function = 0;  // індекс як у WithTestFunction
+    size_t populationSize = 50;
+    size_t dimensions = 1;
+    int generations = 100;
+    uint64_t seed = 1;
+    size_t threads = 1; // 0 - усі ядра, 1 - без пулу
+    int engine = 0;     // індекс як у WithRandomEngine
+    int simd = -1;      // індекс як у SimdLevel, -1 - найширший підтримуваний
+    float searchMin = -10.0f;
+    float searchMax = 10.0f;
+    size_t chromosomeLength = 16;
+    float crossoverRate = 0.8f;
+    float mutationRate = 0.1f;
+    int crossoverType = 0;
+    bool grayCoding = false;
+    bool fitnessCache = false;
+    size_t tournamentSize = 3;
+    int reportEvery = 0; // 0 - лише підсумок
+    std::string tracePath; // порожній - без трасування
+    size_t traceEvents = size_t(1) << 20; // ємність кільця подій на потік, 24 байти на подію
+};
+
+const char* algorithmNames[] = { "ga", "gwo" };
+const char* functionNames[] = { "parabola", "rastrigin", "custom", "ackley", "griewank" };
+static_assert(std::size(functionNames) == TestFunctionCount);
+const char* crossoverNames[] = { "single", "two", "uniform" };
+const char* engineNames[] = { "xoshiro", "pcg64", "philox" };
+const char* simdNames[] = { "scalar", "sse2", "avx2", "avx512" };
+
+void PrintUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --algorithm ga|gwo          (default ga)\n"
+              << "  --function parabola|rastrigin|custom|ackley|griewank (default parabola)\n"
+              << "  --population N              (default 50)\n"
+              << "  --dimensions N              search space dimensions (default 1)\n"
+              << "  --generations N             (default 100)\n"
+              << "  --seed N                    (default 1)\n"
+              << "  --threads N                 0 = all cores, 1 = single thread (default 1)\n"
+              << "  --engine xoshiro|pcg64|philox random engine (default xoshiro)\n"
+              << "  --simd scalar|sse2|avx2|avx512 cap the kernels, to compare them (default: best supported)\n"
+              << "  --min X --max X             search range in every dimension (default -10 10)\n"
+              << "  --report N                  print the best solution every N generations\n"
+              << "  --trace FILE                write a Chrome trace (chrome://tracing, Perfetto) of the run\n"
+              << "  --trace-events N            trace ring capacity per thread, oldest are dropped (default 1048576)\n"
+              << "GA only:\n"
+              << "  --chromosome N              bits per dimension, 1..64 (default 16)\n"
+              << "  --crossover-rate X          (default 0.8)\n"
+              << "  --mutation-rate X           (default 0.1)\n"
+              << "  --crossover single|two|uniform (default single)\n"
+              << "  --gray                      Gray-coded chromosomes\n"
+              << "  --cache                     memoize fitness by genotype\n"
+              << "  --tournament N              (default 3)\n";
+}
+
+// Індекс name у names, або -1
+template <size_t N>
+int FindName(const char* (&names)[N], const std::string& name) {
+    for (size_t i = 0; i < N; ++i) {
+        if (name == names[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Невід'ємне ціле: std::stoul сам приймає "-5" і загортає його у величезне число
+size_t ParseCount(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start != std::string::npos && value[start] == '-') throw std::invalid_argument(value);
+    return std::stoull(value);
+}
+
+// Повертає false, якщо аргументи некоректні (повідомлення вже виведене)
+bool ParseArguments(int argc, char** argv, RunOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            std::exit(0);
+        }
+        if (arg == "--gray") {
+            options.grayCoding = true;
+            continue;
+        }
+        if (arg == "--cache") {
+            options.fitnessCache = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--algorithm") options.algorithm = FindName(algorithmNames, value);
+            else if (arg == "--function") options.function = FindName(functionNames, value);
+            else if (arg == "--crossover") options.crossoverType = FindName(crossoverNames, value);
+            else if (arg == "--engine") options.engine = FindName(engineNames, value);
+            else if (arg == "--simd") {
+                options.simd = FindName(simdNames, value);
+                if (options.simd < 0) {
+                    std::cerr << "Unknown SIMD level " << value << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--population") options.populationSize = ParseCount(value);
+            else if (arg == "--dimensions") options.dimensions = ParseCount(value);
+            else if (arg == "--generations") options.generations = std::stoi(value);
+            else if (arg == "--seed") options.seed = std::stoull(value);
+            else if (arg == "--threads") options.threads = ParseCount(value);
+            else if (arg == "--min") options.searchMin = std::stof(value);
+            else if (arg == "--max") options.searchMax = std::stof(value);
+            else if (arg == "--report") options.reportEvery = std::stoi(value);
+            else if (arg == "--trace") options.tracePath = value;
+            else if (arg == "--trace-events") options.traceEvents = ParseCount(value);
+            else if (arg == "--chromosome") options.chromosomeLength = ParseCount(value);
+            else if (arg == "--crossover-rate") options.crossoverRate = std::stof(value);
+            else if (arg == "--mutation-rate") options.mutationRate = std::stof(value);
+            else if (arg == "--tournament") options.tournamentSize = ParseCount(value);
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+
+    if (options.algorithm < 0 || options.function < 0 || options.crossoverType < 0 || options.engine < 0) {
+        std::cerr << "Unknown algorithm, function, crossover or engine name" << std::endl;
+        return false;
+    }
+    if (options.populationSize < 2 || options.dimensions < 1 || options.generations < 0 || options.searchMin >= options.searchMax) {
+        std::cerr << "Population must be at least 2, dimensions positive, generations non-negative and min < max" << std::endl;
+        return false;
+    }
+    if (options.chromosomeLength < 1 || options.chromosomeLength > 64 || options.tournamentSize < 1 || options.traceEvents < 1) {
+        std::cerr << "Chromosome must be 1..64 bits, tournament and trace events at least 1" << std::endl;
+        return false;
+    }
+    if (!options.tracePath.empty() && !DEMO_PROFILING) {
+        std::cerr << "Tracing is compiled out, rebuild with -DDEMO_PROFILING=ON" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Перші координати точки; у великих вимірностях решта пропускається
+void PrintPoint(std::span<const float> point, const char* format) {
+    const size_t shown = 8;
+    std::printf("(");
+    for (size_t d = 0; d < std::min(point.size(), shown); ++d) {
+        if (d > 0) std::printf(", ");
+        std::printf(format, point[d]);
+    }
+    if (point.size() > shown) std::printf(", ... %zu more", point.size() - shown);
+    std::printf(")");
+}
+
+template <typename Optimizer, typename Function>
+void Report(const Optimizer& optimizer, const Function& function, std::span<const float> best) {
+    std::span<const float> point = best.first(optimizer.GetDimensions());
+    std::printf("generation %d: best x = ", optimizer.GetCurrentGeneration());
+    PrintPoint(point, "%.7g");
+    std::printf(", f(x) = %.7g\n", function(point));
+}
+
+template <typename Optimizer, typename Function>
+void RunOptimizer(Optimizer& optimizer, const Function& function, const RunOptions& options) {
+    if (!options.tracePath.empty()) GlobalTrace().Start(options.traceEvents);
+    auto start = std::chrono::steady_clock::now();
+    for (int generation = 0; generation < options.generations; ++generation) {
+        optimizer.RunGeneration(function);
+        if (options.reportEvery > 0 && optimizer.GetCurrentGeneration() % options.reportEvery == 0) {
+            Report(optimizer, function, optimizer.GetBestPositions());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    GlobalTrace().Stop();
+
+    std::span<const float> point = optimizer.GetBestPositions().first(optimizer.GetDimensions());
+    std::printf("algorithm:   %s\n", algorithmNames[options.algorithm]);
+    std::printf("function:    %s\n", functionNames[options.function]);
+    std::printf("population:  %zu\n", options.populationSize);
+    std::printf("dimensions:  %zu\n", options.dimensions);
+    std::printf("generations: %d\n", optimizer.GetCurrentGeneration());
+    std::printf("seed:        %llu\n", static_cast<unsigned long long>(options.seed));
+    std::printf("engine:      %s\n", engineNames[options.engine]);
+    std::printf("simd:        %s\n", SimdLevelName(GetSimdLevel()));
+    if (point.size() == 1) {
+        std::printf("best x:      %.9g\n", point[0]);
+    } else {
+        std::printf("best x:      ");
+        PrintPoint(point, "%.9g");
+        std::printf("\n");
+    }
+    std::printf("best f(x):   %.9g\n", function(point));
+    std::printf("time:        %.3f ms (%.0f generations/s)\n", seconds * 1000.0,
+                seconds > 0.0 ? options.generations / seconds : 0.0);
+
+    if (!options.tracePath.empty()) {
+        uint64_t dropped = 0;
+        if (GlobalTrace().WriteChromeTrace(options.tracePath, &dropped)) {
+            std::printf("trace:       %s", options.tracePath.c_str());
+            if (dropped > 0) std::printf(" (%llu oldest events dropped, raise --trace-events)", static_cast<unsigned long long>(dropped));
+            std::printf("\n");
+        } else {
+            std::fprintf(stderr, "Cannot write trace to %s\n", options.tracePath.c_str());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    RunOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.simd >= 0) SetSimdLevel(static_cast<SimdLevel>(options.simd));
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads != 1) {
+        pool = std::make_unique<ThreadPool>(options.threads == 0 ? std::thread::hardware_concurrency() : options.threads);
+    }
+
+    std::vector<float> lower(options.dimensions, options.searchMin);
+    std::vector<float> upper(options.dimensions, options.searchMax);
+
+    // Малі вимірності йдуть через інстанціювання з фіксованою кількістю вимірів
+    WithDimensions(options.dimensions, [&](auto dimensions) {
+        constexpr size_t D = decltype(dimensions)::value;
+        WithRandomEngine(options.engine, [&](auto engine) {
+            using Engine = typename decltype(engine)::type;
+            WithTestFunction(options.function, [&](auto function) {
+                if (options.algorithm == 0) {
+                    GeneticAlgorithm<D, Engine> ga;
+                    ga.Initialize(options.populationSize, options.chromosomeLength, lower, upper,
+                                  options.crossoverRate, options.mutationRate, options.seed,
+                                  static_cast<CrossoverType>(options.crossoverType), options.grayCoding, options.tournamentSize);
+                    ga.SetThreadPool(pool.get());
+                    ga.EnableFitnessCache(options.fitnessCache);
+                    ga.EvaluateFitness(function);
+                    RunOptimizer(ga, function, options);
+                    if (options.fitnessCache) {
+                        FitnessCacheStats stats = ga.GetFitnessCacheStats();
+                        std::printf("cache:       %llu hits, %llu misses (%.1f%% hit rate)\n", static_cast<unsigned long long>(stats.hits),
+                                    static_cast<unsigned long long>(stats.misses), stats.HitRate() * 100.0);
+                    }
+                } else {
+                    GreyWolfOptimizer<D, Engine> gwo;
+                    gwo.Initialize(options.populationSize, lower, upper, options.seed);
+                    gwo.SetThreadPool(pool.get());
+                    RunOptimizer(gwo, function, options);
+                }
+            });
+        });
+    });
+    return 0;
+}
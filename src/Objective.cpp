@@ -0,0 +1,58 @@
+#pragma once
+#include <cassert>
+#include <span>
+#include <type_traits>
+#include "Dimensions.cpp"
+
+// Точки передаються матрицею count x D у порядку рядків: точка i займає xs[i * D, (i + 1) * D),
+// кількість вимірів D = xs.size() / out.size().
+// Пакетна цільова функція: out[i] = f(точка i) для всіх точок за один виклик.
+// Оптимізатори викликають її один раз на покоління (або один раз на шматок у багатопотоковому режимі)
+template <typename Objective>
+concept BatchObjective = std::is_invocable_v<const Objective&, std::span<const float>, std::span<float>>;
+
+// Функція однієї точки: float(span<const float>) з D координатами
+template <typename Objective>
+concept PointObjective = std::is_invocable_r_v<float, const Objective&, std::span<const float>>;
+
+// float(float) - лише для одновимірного пошуку
+template <typename Objective>
+concept ScalarObjective = std::is_invocable_r_v<float, const Objective&, float>;
+
+// Адаптер функції однієї точки (або float(float) при D = 1) до пакетного інтерфейсу.
+// Dimensions - вимірність, відома під час компіляції: тоді точки мають сталий розмір і цикл функції розгортається
+template <typename Function, size_t Dimensions = DynamicDimensions>
+struct BatchAdapter {
+    Function function;
+
+    void operator()(std::span<const float> xs, std::span<float> out) const {
+        if (out.empty()) return;
+        const size_t dimensions = (Dimensions == DynamicDimensions) ? xs.size() / out.size() : Dimensions;
+        if constexpr (PointObjective<Function>) {
+            for (size_t i = 0; i < out.size(); ++i) {
+                out[i] = function(xs.subspan(i * dimensions, dimensions));
+            }
+        } else {
+            assert(dimensions == 1 && "float(float) objective used for a multi-dimensional search");
+            for (size_t i = 0; i < out.size(); ++i) {
+                out[i] = function(xs[i]);
+            }
+        }
+    }
+};
+
+template <typename Function>
+BatchAdapter<Function> MakeBatchObjective(Function function) {
+    return BatchAdapter<Function>{ function };
+}
+
+template <size_t Dimensions = DynamicDimensions, typename Objective>
+void EvaluateBatch(const Objective& objective, std::span<const float> xs, std::span<float> out) {
+    if constexpr (BatchObjective<Objective>) {
+        objective(xs, out);
+    } else {
+        static_assert(PointObjective<Objective> || ScalarObjective<Objective>,
+                      "objective must be float(span<const float>), float(float) or void(span<const float>, span<float>)");
+        BatchAdapter<const Objective&, Dimensions>{ objective }(xs, out);
+    }
+}
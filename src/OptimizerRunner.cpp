@@ -0,0 +1,144 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "FitnessCache.cpp"
+
+// Стан оптимізатора, який бачить GUI
+struct OptimizerSnapshot {
+    int generation = 0;
+    std::vector<float> bestPositions;
+    FitnessCacheStats cacheStats; // лише GA
+};
+
+// Потрійний буфер без блокувань: письменник завжди має вільний слот і ніколи не чекає,
+// читач забирає найсвіжіший повний знімок. Один письменник і один читач
+template <typename T>
+class SnapshotBuffer {
+private:
+    static constexpr uint8_t IndexMask = 3;
+    static constexpr uint8_t FreshBit = 4;
+
+    T slots[3];
+    // Індекс останнього опублікованого слота; FreshBit - читач його ще не забрав
+    std::atomic<uint8_t> latest;
+    uint8_t writeIndex;
+    uint8_t readIndex;
+
+public:
+    SnapshotBuffer() : latest(0), writeIndex(1), readIndex(2) {}
+
+    T& WriteSlot() { return slots[writeIndex]; }
+
+    void Publish() {
+        writeIndex = latest.exchange(writeIndex | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // true, якщо з'явився новий знімок; тоді ReadSlot() повертає його
+    bool Consume() {
+        if ((latest.load(std::memory_order_relaxed) & FreshBit) == 0) return false;
+        readIndex = latest.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    const T& ReadSlot() const { return slots[readIndex]; }
+};
+
+// Фоновий потік, що крутить покоління незалежно від частоти кадрів.
+// Step виконує одне покоління, заповнює знімок і повертає false, коли пора зупинитися.
+// Поки потік працює, оптимізатор належить йому; GUI звертається до оптимізатора лише після Pause()
+class OptimizerRunner {
+public:
+    using Step = std::function<bool(OptimizerSnapshot&)>;
+
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable idleCondition;
+    Step step;
+    bool busy;
+    bool stopping;
+    std::atomic<bool> running;
+    std::atomic<int> generationsPerSecond; // 0 - без обмеження
+    SnapshotBuffer<OptimizerSnapshot> snapshots;
+
+    void WorkerLoop() {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point nextStep = Clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeCondition.wait(lock, [&] { return stopping || running.load(); });
+            if (stopping) return;
+
+            // Обмеження швидкості: чекаємо свого часу, але Pause і зупинка перериваються одразу
+            int rate = generationsPerSecond.load(std::memory_order_relaxed);
+            if (rate > 0) {
+                if (wakeCondition.wait_until(lock, nextStep, [&] { return stopping || !running.load(); })) continue;
+                nextStep = std::max(nextStep, Clock::now() - std::chrono::milliseconds(100)) +
+                           std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+            } else {
+                nextStep = Clock::now();
+            }
+
+            busy = true;
+            lock.unlock();
+            bool keepRunning = step(snapshots.WriteSlot());
+            snapshots.Publish();
+            lock.lock();
+            busy = false;
+            if (!keepRunning) running.store(false);
+            idleCondition.notify_all();
+        }
+    }
+
+public:
+    OptimizerRunner() : busy(false), stopping(false), running(false), generationsPerSecond(0) {
+        worker = std::thread([this] { WorkerLoop(); });
+    }
+
+    ~OptimizerRunner() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        worker.join();
+    }
+
+    OptimizerRunner(const OptimizerRunner&) = delete;
+    OptimizerRunner& operator=(const OptimizerRunner&) = delete;
+
+    void Start(Step newStep) {
+        Pause();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            step = std::move(newStep);
+            running.store(true);
+        }
+        wakeCondition.notify_all();
+    }
+
+    // Повертається, коли поточне покоління завершене; непрочитаний знімок відкидається
+    void Pause() {
+        std::unique_lock<std::mutex> lock(mutex);
+        running.store(false);
+        wakeCondition.notify_all();
+        idleCondition.wait(lock, [&] { return !busy; });
+        snapshots.Consume();
+    }
+
+    bool IsRunning() const { return running.load(); }
+
+    void SetRateLimit(int perSecond) { generationsPerSecond.store(perSecond, std::memory_order_relaxed); }
+
+    // Для потоку GUI: true, якщо з'явився новий знімок
+    bool PollSnapshot() { return snapshots.Consume(); }
+    const OptimizerSnapshot& GetSnapshot() const { return snapshots.ReadSlot(); }
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Trace.cpp"
+
+// Профілювання фаз гарячого шляху. Без DEMO_PROFILING макроси PROFILE_SCOPE, PROFILE_COMMIT і TRACE_SCOPE
+// розгортаються в нічого, тож таймери не коштують нічого навіть у циклах по шматках.
+// Трасування (Trace.cpp) вмикається під час виконання через GlobalTrace().Start() і пише ті самі фази
+#ifndef DEMO_PROFILING
+#define DEMO_PROFILING 0
+#endif
+
+// Фази поділені на групи з власним темпом: фази оптимізатора підсумовуються за покоління
+// (на фоновому потоці), фази кадру - за кадр (на потоці GUI)
+enum class ProfilePhase {
+    GaSelection, GaCrossover, GaMutation, GaDecoding, GaEvaluation,
+    GwoEvaluation, GwoLeaderUpdate, GwoPositionUpdate,
+    FrameUpdate, FrameRender, FrameDrawFunction,
+    Count
+};
+
+enum class ProfileGroup { Optimizer, Frame };
+
+inline const char* ProfilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::GaSelection: return "GA selection";
+        case ProfilePhase::GaCrossover: return "GA crossover";
+        case ProfilePhase::GaMutation: return "GA mutation";
+        case ProfilePhase::GaDecoding: return "GA decoding";
+        case ProfilePhase::GaEvaluation: return "GA evaluation";
+        case ProfilePhase::GwoEvaluation: return "GWO evaluation";
+        case ProfilePhase::GwoLeaderUpdate: return "GWO leader update";
+        case ProfilePhase::GwoPositionUpdate: return "GWO position update";
+        case ProfilePhase::FrameUpdate: return "Update()";
+        case ProfilePhase::FrameRender: return "Render()";
+        case ProfilePhase::FrameDrawFunction: return "DrawFunction()";
+        default: return "?";
+    }
+}
+
+inline ProfileGroup ProfilePhaseGroup(ProfilePhase phase) {
+    return phase >= ProfilePhase::FrameUpdate ? ProfileGroup::Frame : ProfileGroup::Optimizer;
+}
+
+// Фаза, всередині якої виміряна вкладена фаза, або Count для фаз верхнього рівня.
+// Час вкладеної фази вже входить у батьківську, тож до суми групи вона не додається
+inline ProfilePhase ProfilePhaseParent(ProfilePhase phase) {
+    return phase == ProfilePhase::FrameDrawFunction ? ProfilePhase::FrameRender : ProfilePhase::Count;
+}
+
+// Накопичує час фаз у поточному покоління/кадрі й зберігає останні HistoryLength значень кожної фази.
+// Фаза всередині ParallelFor рахується як сума часу всіх потоків, що її виконували.
+// Add викликається з будь-якого потоку, Commit групи - лише з потоку, що цю групу веде;
+// історію читає GUI, тож усі комірки атомарні
+class Profiler {
+public:
+    static constexpr size_t PhaseCount = static_cast<size_t>(ProfilePhase::Count);
+    static constexpr size_t HistoryLength = 240;
+
+private:
+    std::array<std::atomic<uint64_t>, PhaseCount> pending{};
+    std::array<std::array<std::atomic<float>, HistoryLength>, PhaseCount> history{};
+    std::array<std::atomic<size_t>, 2> samples{}; // записані зразки кожної групи
+
+public:
+    void Add(ProfilePhase phase, uint64_t nanoseconds) {
+        pending[static_cast<size_t>(phase)].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    // Закриває зразок групи: накопичений час кожної фази переходить в історію, лічильник обнуляється
+    void Commit(ProfileGroup group) {
+        size_t sample = samples[static_cast<size_t>(group)].load(std::memory_order_relaxed);
+        for (size_t p = 0; p < PhaseCount; ++p) {
+            if (ProfilePhaseGroup(static_cast<ProfilePhase>(p)) != group) continue;
+            uint64_t nanoseconds = pending[p].exchange(0, std::memory_order_relaxed);
+            history[p][sample % HistoryLength].store(static_cast<float>(nanoseconds * 1e-6), std::memory_order_relaxed);
+        }
+        samples[static_cast<size_t>(group)].store(sample + 1, std::memory_order_release);
+    }
+
+    size_t SampleCount(ProfileGroup group) const {
+        return samples[static_cast<size_t>(group)].load(std::memory_order_acquire);
+    }
+
+    // Останні зразки фази в мілісекундах, від найстаршого; повертає їхню кількість (не більше HistoryLength)
+    size_t CopyHistory(ProfilePhase phase, float* out) const {
+        size_t total = SampleCount(ProfilePhaseGroup(phase));
+        size_t count = total < HistoryLength ? total : HistoryLength;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = history[static_cast<size_t>(phase)][(total - count + i) % HistoryLength].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    void Reset() {
+        for (auto& value : pending) value.store(0, std::memory_order_relaxed);
+        for (auto& value : samples) value.store(0, std::memory_order_relaxed);
+    }
+};
+
+inline Profiler& GlobalProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+class ScopedTimer {
+private:
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(ProfilePhase timedPhase) : phase(timedPhase), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto end = std::chrono::steady_clock::now();
+        auto elapsed = end - start;
+        GlobalTrace().Record(ProfilePhaseName(phase), start, end);
+        GlobalProfiler().Add(phase, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if DEMO_PROFILING
+#define PROFILE_SCOPE(phase) ScopedTimer PROFILE_CONCAT(scopedTimer, __LINE__)(phase)
+#define PROFILE_COMMIT(group) GlobalProfiler().Commit(group)
+#define TRACE_SCOPE(name) TraceScope PROFILE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(phase) ((void)0)
+#define PROFILE_COMMIT(group) ((void)0)
+#define TRACE_SCOPE(name) ((void)0)
+#endif
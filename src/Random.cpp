@@ -0,0 +1,390 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <concepts>
+#include <type_traits>
+#include <vector>
+#include "Simd.cpp"
+
+// Генератори, які приймають оптимізатори: 64-бітний UniformRandomBitGenerator,
+// що засівається парою (seed, stream). Різні stream при одному seed дають незалежні потоки
+template <typename Engine>
+concept RandomEngine = std::uniform_random_bit_generator<Engine> &&
+                       std::same_as<typename Engine::result_type, uint64_t> &&
+                       std::constructible_from<Engine, uint64_t, uint64_t>;
+
+// Генератор для засівання інших генераторів з одного 64-бітного числа
+inline uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t RotateLeft(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t RotateRight(uint64_t x, unsigned k) {
+    return (x >> k) | (x << ((64 - k) & 63));
+}
+
+// Номер потоку хешується в seed, щоб сусідні потоки не давали зсунутих копій послідовності SplitMix64
+inline uint64_t MixStream(uint64_t seed, uint64_t stream) {
+    uint64_t state = stream ^ 0x6A09E667F3BCC909ULL;
+    return seed ^ SplitMix64(state);
+}
+
+// Недетермінований 64-бітний seed для запусків без явного seed
+inline uint64_t RandomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+// Рівномірний float із [0, 1) зі старших 24 біт 32-бітного числа
+inline float UnitFloat(uint32_t bits) {
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+// Старші 64 біти 128-бітного добутку
+inline uint64_t MulHigh64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+    uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + lowHigh;
+    return aHigh * bHigh + (highLow >> 32) + (cross >> 32);
+#endif
+}
+
+// Рівномірне ціле з [0, bound) (Lemire): множення замість ділення, повтор лише для рідкісних
+// залишків. На відміну від uniform_int_distribution, результат однаковий у всіх стандартних бібліотеках
+template <typename Engine>
+uint64_t UniformIndex(Engine& gen, uint64_t bound) {
+    uint64_t x = gen();
+    uint64_t low = x * bound;
+    if (low < bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        while (low < threshold) {
+            x = gen();
+            low = x * bound;
+        }
+    }
+    return MulHigh64(x, bound);
+}
+
+// xoshiro256++ (Blackman, Vigna): 32 байти стану, період 2^256 - 1
+class Xoshiro256PlusPlus {
+private:
+    uint64_t s[4];
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256PlusPlus(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void seed(uint64_t value, uint64_t stream = 0) {
+        value = MixStream(value, stream);
+        for (uint64_t& word : s) {
+            word = SplitMix64(value);
+        }
+    }
+
+    const uint64_t* GetState() const { return s; }
+
+    result_type operator()() {
+        uint64_t result = RotateLeft(s[0] + s[3], 23) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = RotateLeft(s[3], 45);
+        return result;
+    }
+
+    // Еквівалент 2^128 викликів: дає непересічні підпослідовності для паралельних потоків
+    void Jump() {
+        static const uint64_t jump[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (uint64_t mask : jump) {
+            for (int b = 0; b < 64; ++b) {
+                if (mask & (uint64_t(1) << b)) {
+                    for (int i = 0; i < 4; ++i) t[i] ^= s[i];
+                }
+                (*this)();
+            }
+        }
+        std::memcpy(s, t, sizeof(s));
+    }
+};
+
+// Вісім незалежних потоків xoshiro256++ у форматі структури масивів.
+// Fill видає рівномірні float із [0, 1) по 16 за крок; результат однаковий на всіх рівнях SIMD
+class BulkUniformGenerator {
+private:
+    static constexpr size_t Lanes = 8;
+    static constexpr size_t FloatsPerStep = 2 * Lanes;
+    alignas(64) uint64_t s[4][Lanes];
+
+    // Кожне 64-бітне число дає два float: старші 24 біти нижньої та верхньої половин
+    void StepScalar(float* out) {
+        for (size_t l = 0; l < Lanes; ++l) {
+            uint64_t result = RotateLeft(s[0][l] + s[3][l], 23) + s[0][l];
+            uint64_t t = s[1][l] << 17;
+            s[2][l] ^= s[0][l];
+            s[3][l] ^= s[1][l];
+            s[1][l] ^= s[2][l];
+            s[0][l] ^= s[3][l];
+            s[2][l] ^= t;
+            s[3][l] = RotateLeft(s[3][l], 45);
+
+            out[2 * l] = UnitFloat(static_cast<uint32_t>(result));
+            out[2 * l + 1] = UnitFloat(static_cast<uint32_t>(result >> 32));
+        }
+    }
+
+    void FillScalar(float* out, size_t steps) {
+        for (size_t i = 0; i < steps; ++i) {
+            StepScalar(out + i * FloatsPerStep);
+        }
+    }
+
+#if SIMD_X86
+    SIMD_TARGET_AVX2 static __m256i RotateLeftAvx2(__m256i x, int k) {
+        return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    }
+
+    SIMD_TARGET_AVX2 void FillAvx2(float* out, size_t steps) {
+        const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+        for (size_t half = 0; half < 2; ++half) {
+            __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[0][half * 4]));
+            __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[1][half * 4]));
+            __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[2][half * 4]));
+            __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[3][half * 4]));
+            for (size_t i = 0; i < steps; ++i) {
+                __m256i result = _mm256_add_epi64(RotateLeftAvx2(_mm256_add_epi64(s0, s3), 23), s0);
+                __m256i t = _mm256_slli_epi64(s1, 17);
+                s2 = _mm256_xor_si256(s2, s0);
+                s3 = _mm256_xor_si256(s3, s1);
+                s1 = _mm256_xor_si256(s1, s2);
+                s0 = _mm256_xor_si256(s0, s3);
+                s2 = _mm256_xor_si256(s2, t);
+                s3 = RotateLeftAvx2(s3, 45);
+
+                __m256 values = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(result, 8)), scale);
+                _mm256_storeu_ps(out + i * FloatsPerStep + half * 8, values);
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&s[0][half * 4]), s0);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&s[1][half * 4]), s1);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&s[2][half * 4]), s2);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&s[3][half * 4]), s3);
+        }
+    }
+#endif
+
+public:
+    BulkUniformGenerator(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    // Смуги - послідовні стрибки одного xoshiro256++, тож вони не перетинаються
+    void seed(uint64_t value, uint64_t stream = 0) {
+        Xoshiro256PlusPlus lane(value, stream);
+        for (size_t l = 0; l < Lanes; ++l) {
+            for (int i = 0; i < 4; ++i) s[i][l] = lane.GetState()[i];
+            lane.Jump();
+        }
+    }
+
+    void Fill(float* out, size_t count) {
+        size_t steps = count / FloatsPerStep;
+#if SIMD_X86
+        if (GetSimdLevel() >= SimdLevel::Avx2) {
+            FillAvx2(out, steps);
+        } else {
+            FillScalar(out, steps);
+        }
+#else
+        FillScalar(out, steps);
+#endif
+        size_t tail = count - steps * FloatsPerStep;
+        if (tail > 0) {
+            float last[FloatsPerStep];
+            StepScalar(last);
+            std::memcpy(out + steps * FloatsPerStep, last, tail * sizeof(float));
+        }
+    }
+};
+
+// PCG64 (O'Neill, XSL-RR 128/64): 128-бітний LCG, потік задає інкремент
+class Pcg64 {
+private:
+    uint64_t stateHigh, stateLow;
+    uint64_t incHigh, incLow;
+
+    static constexpr uint64_t MulHigh = 0x2360ED051FC65DA4ULL;
+    static constexpr uint64_t MulLow = 0x4385DF649FCCF645ULL;
+
+    void Step() {
+        // state = state * multiplier + increment (mod 2^128)
+        uint64_t high = MulHigh64(stateLow, MulLow) + stateHigh * MulLow + stateLow * MulHigh;
+        uint64_t low = stateLow * MulLow;
+        stateLow = low + incLow;
+        stateHigh = high + incHigh + (stateLow < low ? 1 : 0);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Pcg64(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    // Як pcg64(seed, stream) у pcg-cpp
+    void seed(uint64_t value, uint64_t stream = 0) {
+        incHigh = stream >> 63;
+        incLow = (stream << 1) | 1;
+        stateHigh = stateLow = 0;
+        Step();
+        uint64_t low = stateLow + value;
+        stateHigh += (low < stateLow ? 1 : 0);
+        stateLow = low;
+        Step();
+    }
+
+    result_type operator()() {
+        Step();
+        return RotateRight(stateHigh ^ stateLow, static_cast<unsigned>(stateHigh >> 58));
+    }
+};
+
+// Philox4x32-10 (Salmon et al.): генератор на лічильнику. Ключ - seed, лічильник - (номер блоку, stream),
+// тож будь-який потік і будь-яку позицію в ньому можна отримати без послідовного проходу
+class Philox4x32 {
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t output[4];
+    unsigned outputIndex;
+
+    static void MulHiLo(uint32_t a, uint32_t b, uint32_t& high, uint32_t& low) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        high = static_cast<uint32_t>(product >> 32);
+        low = static_cast<uint32_t>(product);
+    }
+
+    void GenerateBlock() {
+        uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint32_t high0, low0, high1, low1;
+            MulHiLo(0xD2511F53u, c[0], high0, low0);
+            MulHiLo(0xCD9E8D57u, c[2], high1, low1);
+            uint32_t next[4] = { high1 ^ c[1] ^ k0, low1, high0 ^ c[3] ^ k1, low0 };
+            std::memcpy(c, next, sizeof(c));
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        std::memcpy(output, c, sizeof(output));
+
+        if (++counter[0] == 0) ++counter[1];
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void seed(uint64_t value, uint64_t stream = 0) {
+        key[0] = static_cast<uint32_t>(value);
+        key[1] = static_cast<uint32_t>(value >> 32);
+        counter[0] = counter[1] = 0;
+        counter[2] = static_cast<uint32_t>(stream);
+        counter[3] = static_cast<uint32_t>(stream >> 32);
+        outputIndex = 4;
+    }
+
+    // Перехід до блоку block (по два 64-бітні числа на блок) за O(1)
+    void SeekBlock(uint64_t block) {
+        counter[0] = static_cast<uint32_t>(block);
+        counter[1] = static_cast<uint32_t>(block >> 32);
+        outputIndex = 4;
+    }
+
+    const uint32_t* GetBlock() const { return output; }
+
+    result_type operator()() {
+        if (outputIndex >= 4) {
+            GenerateBlock();
+            outputIndex = 0;
+        }
+        uint64_t result = output[outputIndex] | (static_cast<uint64_t>(output[outputIndex + 1]) << 32);
+        outputIndex += 2;
+        return result;
+    }
+};
+
+// Потік рівномірних float для гарячих циклів. Загальний випадок бере по два float з кожного
+// 64-бітного числа; для xoshiro256++ використовується восьмисмуговий SIMD-генератор
+template <RandomEngine Engine>
+class UniformStream {
+private:
+    Engine engine;
+
+public:
+    explicit UniformStream(uint64_t seed = 0, uint64_t stream = 0) : engine(seed, stream) {}
+
+    void Fill(float* out, size_t count) {
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            uint64_t bits = engine();
+            out[i] = UnitFloat(static_cast<uint32_t>(bits));
+            out[i + 1] = UnitFloat(static_cast<uint32_t>(bits >> 32));
+        }
+        if (i < count) {
+            out[i] = UnitFloat(static_cast<uint32_t>(engine()));
+        }
+    }
+};
+
+template <>
+class UniformStream<Xoshiro256PlusPlus> : public BulkUniformGenerator {
+public:
+    explicit UniformStream(uint64_t seed = 0, uint64_t stream = 0) : BulkUniformGenerator(seed, stream) {}
+};
+
+// Вибір генератора за індексом (0 - xoshiro256++, 1 - PCG64, 2 - Philox4x32-10), щоб порівнювати їх
+// з командного рядка. fn отримує std::type_identity<Engine>
+template <typename Fn>
+void WithRandomEngine(int index, Fn&& fn) {
+    switch (index) {
+        case 1: fn(std::type_identity<Pcg64>{}); break;
+        case 2: fn(std::type_identity<Philox4x32>{}); break;
+        default: fn(std::type_identity<Xoshiro256PlusPlus>{}); break;
+    }
+}
+
+// Потоки шматків: спільний seed із головного генератора, номер шматка - номер потоку,
+// тож результат не залежить від того, який робочий потік узяв шматок
+template <typename Stream, typename Engine>
+void SeedChunkStreams(std::vector<Stream>& streams, Engine& rng, size_t chunkCount) {
+    uint64_t streamSeed = rng();
+    streams.clear();
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        streams.emplace_back(streamSeed, chunk);
+    }
+}
+
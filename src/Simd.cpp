@@ -0,0 +1,101 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <new>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// GCC/Clang компілюють AVX-ядра окремо від базової цілі, MSVC дозволяє інтринсики без прапорів.
+// З fma у цілі компілятор зливає mul + add у FMA; ядрам, що мають збігатися зі скалярним кодом біт у біт, - NO_FMA
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX2_NO_FMA __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX2_NO_FMA
+#define SIMD_TARGET_AVX512
+#endif
+
+enum class SimdLevel { Scalar, Sse2, Avx2, Avx512 };
+
+inline const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Sse2: return "SSE2";
+        case SimdLevel::Avx2: return "AVX2";
+        case SimdLevel::Avx512: return "AVX-512";
+        default: return "Scalar";
+    }
+}
+
+// Найкращий набір інструкцій, який підтримують і процесор, і ОС
+inline SimdLevel DetectSimdLevel() {
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::Avx2;
+    return SimdLevel::Sse2;
+#elif SIMD_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osXsave = (info[2] & (1 << 27)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    unsigned long long xcr0 = osXsave ? _xgetbv(0) : 0;
+    bool avxState = (xcr0 & 0x6) == 0x6;
+    bool avx512State = (xcr0 & 0xE6) == 0xE6;
+    __cpuidex(info, 7, 0);
+    if (avx512State && (info[1] & (1 << 16))) return SimdLevel::Avx512;
+    if (avxState && fma && (info[1] & (1 << 5))) return SimdLevel::Avx2;
+    return SimdLevel::Sse2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+inline SimdLevel& ActiveSimdLevel() {
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+inline SimdLevel GetSimdLevel() { return ActiveSimdLevel(); }
+
+// Дозволяє примусово знизити рівень (для порівняння ядер); вище за підтримуваний не піднімається
+inline void SetSimdLevel(SimdLevel level) {
+    ActiveSimdLevel() = std::min(level, DetectSimdLevel());
+}
+
+// Алокатор з вирівнюванням під кеш-лінію (і під 512-бітні регістри)
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, size_t) {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
@@ -0,0 +1,226 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+#include "Simd.cpp"
+
+// Підсумок одного покоління: значення цільової функції (менше - краще), різноманітність
+// (середнє за вимірами стандартне відхилення координат) і кількість оцінювань з моменту Initialize
+struct GenerationStats {
+    int generation = 0;
+    float best = 0.0f;
+    float mean = 0.0f;
+    float worst = 0.0f;
+    float diversity = 0.0f;
+    uint64_t evaluations = 0;
+};
+
+// Сума й сума квадратів відхилень від shift, мінімум і максимум. Суми ведуться в double:
+// у float квадрати значень біля нуля стають субнормальними (повільний мікрокод), а довгі суми гублять точність.
+// Зсув на одне зі значень вибірки прибирає взаємне знищення в E[x^2] - E[x]^2 для щільних скупчень далеко від нуля
+struct ValueMoments {
+    double sum = 0.0;
+    double squares = 0.0;
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+};
+
+inline void AccumulateMomentsScalar(ValueMoments& moments, const float* values, size_t count, double shift) {
+    for (size_t i = 0; i < count; ++i) {
+        double delta = static_cast<double>(values[i]) - shift;
+        moments.sum += delta;
+        moments.squares += delta * delta;
+        moments.min = std::min(moments.min, values[i]);
+        moments.max = std::max(moments.max, values[i]);
+    }
+}
+
+#if SIMD_X86
+// Чотири незалежні суми double (дві половини двох регістрів), щоб додавання не стояли в одному ланцюжку
+inline void AccumulateMomentsSse2(ValueMoments& moments, const float* values, size_t count, double shift) {
+    __m128 minValue = _mm_set1_ps(moments.min), maxValue = _mm_set1_ps(moments.max);
+    __m128d shiftValue = _mm_set1_pd(shift);
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+    __m128d squares0 = _mm_setzero_pd(), squares1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(values + i);
+        __m128d low = _mm_sub_pd(_mm_cvtps_pd(x), shiftValue);
+        __m128d high = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), shiftValue);
+        sum0 = _mm_add_pd(sum0, low);
+        sum1 = _mm_add_pd(sum1, high);
+        squares0 = _mm_add_pd(squares0, _mm_mul_pd(low, low));
+        squares1 = _mm_add_pd(squares1, _mm_mul_pd(high, high));
+        minValue = _mm_min_ps(minValue, x);
+        maxValue = _mm_max_ps(maxValue, x);
+    }
+    alignas(16) double sums[2], squares[2];
+    _mm_store_pd(sums, _mm_add_pd(sum0, sum1));
+    _mm_store_pd(squares, _mm_add_pd(squares0, squares1));
+    moments.sum += sums[0] + sums[1];
+    moments.squares += squares[0] + squares[1];
+    alignas(16) float mins[4], maxs[4];
+    _mm_store_ps(mins, minValue);
+    _mm_store_ps(maxs, maxValue);
+    moments.min = *std::min_element(mins, mins + 4);
+    moments.max = *std::max_element(maxs, maxs + 4);
+    AccumulateMomentsScalar(moments, values + i, count - i, shift);
+}
+#endif
+
+// Суцільний масив, відхилення - від першого елемента
+inline ValueMoments AccumulateMoments(const float* values, size_t count) {
+    ValueMoments moments;
+    if (count == 0) return moments;
+#if SIMD_X86
+    AccumulateMomentsSse2(moments, values, count, values[0]);
+#else
+    AccumulateMomentsScalar(moments, values, count, values[0]);
+#endif
+    return moments;
+}
+
+// Стандартне відхилення з moments, накопичених по count значеннях
+inline double Deviation(double sum, double squares, size_t count) {
+    double mean = sum / static_cast<double>(count);
+    return std::sqrt(std::max(squares / static_cast<double>(count) - mean * mean, 0.0));
+}
+
+// negatedFitness - fitness зі зворотним знаком, як його зберігають оптимізатори (більше - краще);
+// positions - матриця count x dimensions у порядку рядків, проходиться один раз по рядках.
+// columns - буфер сум по вимірах, перевикористовується між викликами (після першого пам'ять не виділяється)
+inline GenerationStats SummarizeGeneration(int generation, std::span<const float> negatedFitness, const float* positions,
+                                           size_t dimensions, uint64_t evaluations, std::vector<double>& columns) {
+    GenerationStats stats;
+    stats.generation = generation;
+    stats.evaluations = evaluations;
+    size_t count = negatedFitness.size();
+    if (count == 0) return stats;
+
+    ValueMoments fitness = AccumulateMoments(negatedFitness.data(), count);
+    stats.best = -fitness.max;
+    stats.worst = -fitness.min;
+    stats.mean = static_cast<float>(-(negatedFitness[0] + fitness.sum / static_cast<double>(count)));
+
+    double deviation = 0.0;
+    if (dimensions == 1) {
+        ValueMoments coordinate = AccumulateMoments(positions, count);
+        deviation = Deviation(coordinate.sum, coordinate.squares, count);
+    } else {
+        // Відхилення від першої особини; сума й сума квадратів для всіх вимірів рядка одразу
+        columns.assign(2 * dimensions, 0.0);
+        double* sums = columns.data();
+        double* squares = sums + dimensions;
+        const float* first = positions;
+        for (size_t i = 1; i < count; ++i) {
+            const float* row = positions + i * dimensions;
+            for (size_t d = 0; d < dimensions; ++d) {
+                double delta = static_cast<double>(row[d]) - static_cast<double>(first[d]);
+                sums[d] += delta;
+                squares[d] += delta * delta;
+            }
+        }
+        for (size_t d = 0; d < dimensions; ++d) {
+            deviation += Deviation(sums[d], squares[d], count);
+        }
+    }
+    stats.diversity = static_cast<float>(deviation / static_cast<double>(dimensions));
+    return stats;
+}
+
+// Кільце останніх Capacity поколінь. Пам'ять виділяється один раз у конструкторі, Record не виділяє нічого.
+// Пише один потік (той, що веде оптимізатор), читати можна з іншого одночасно: поля атомарні,
+// а CopyHistory відкидає записи, які письменник встиг перезаписати під час копіювання
+class TelemetryRing {
+public:
+    static constexpr size_t Capacity = 4096;
+
+private:
+    struct Slot {
+        std::atomic<int> generation{ 0 };
+        std::atomic<float> best{ 0.0f }, mean{ 0.0f }, worst{ 0.0f }, diversity{ 0.0f };
+        std::atomic<uint64_t> evaluations{ 0 };
+    };
+
+    struct State {
+        Slot slots[Capacity];
+        std::atomic<uint64_t> written{ 0 };
+    };
+
+    std::unique_ptr<State> state;
+
+public:
+    TelemetryRing() : state(std::make_unique<State>()) {}
+
+    // Лише коли ніхто не пише і не читає (як Initialize оптимізатора)
+    void Clear() { state->written.store(0, std::memory_order_relaxed); }
+
+    void Record(const GenerationStats& stats) {
+        uint64_t index = state->written.load(std::memory_order_relaxed);
+        // Попередній лічильник стає видимим раніше за нові поля: читач, що побачив нове поле, побачить і його
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& slot = state->slots[index % Capacity];
+        slot.generation.store(stats.generation, std::memory_order_relaxed);
+        slot.best.store(stats.best, std::memory_order_relaxed);
+        slot.mean.store(stats.mean, std::memory_order_relaxed);
+        slot.worst.store(stats.worst, std::memory_order_relaxed);
+        slot.diversity.store(stats.diversity, std::memory_order_relaxed);
+        slot.evaluations.store(stats.evaluations, std::memory_order_relaxed);
+        state->written.store(index + 1, std::memory_order_release);
+    }
+
+    uint64_t TotalRecorded() const { return state->written.load(std::memory_order_acquire); }
+
+    // Останні записи від найстаршого, не більше Capacity; повертає їхню кількість
+    size_t CopyHistory(GenerationStats* out) const {
+        uint64_t total = TotalRecorded();
+        size_t count = static_cast<size_t>(std::min<uint64_t>(total, Capacity));
+        uint64_t first = total - count;
+        for (size_t i = 0; i < count; ++i) {
+            const Slot& slot = state->slots[(first + i) % Capacity];
+            out[i].generation = slot.generation.load(std::memory_order_relaxed);
+            out[i].best = slot.best.load(std::memory_order_relaxed);
+            out[i].mean = slot.mean.load(std::memory_order_relaxed);
+            out[i].worst = slot.worst.load(std::memory_order_relaxed);
+            out[i].diversity = slot.diversity.load(std::memory_order_relaxed);
+            out[i].evaluations = slot.evaluations.load(std::memory_order_relaxed);
+        }
+
+        // Записи, на місце яких письменник устиг щось покласти (або кладе саме зараз - запис after),
+        // могли прочитатися наполовину
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = state->written.load(std::memory_order_relaxed);
+        uint64_t overwritten = after + 1 > first + Capacity ? after + 1 - (first + Capacity) : 0;
+        size_t dropped = static_cast<size_t>(std::min<uint64_t>(overwritten, count));
+        if (dropped > 0) std::copy(out + dropped, out + count, out);
+        return count - dropped;
+    }
+};
+
+// Телеметрія оптимізатора: кільце підсумків і буфер для SummarizeGeneration. За замовчуванням вимкнена:
+// підсумок - ще один прохід по всій популяції за покоління, тож її вмикає лише той, хто читає кільце (GUI).
+// Вмикати до запуску поколінь, не з іншого потоку під час роботи
+class GenerationTelemetry {
+private:
+    TelemetryRing ring;
+    std::vector<double> columns;
+    bool enabled = false;
+
+public:
+    void SetEnabled(bool enable) { enabled = enable; }
+    bool IsEnabled() const { return enabled; }
+    void Clear() { ring.Clear(); }
+
+    void Record(int generation, std::span<const float> negatedFitness, const float* positions, size_t dimensions, uint64_t evaluations) {
+        if (!enabled) return;
+        ring.Record(SummarizeGeneration(generation, negatedFitness, positions, dimensions, evaluations, columns));
+    }
+
+    const TelemetryRing& Ring() const { return ring; }
+};
+
@@ -0,0 +1,392 @@
+#pragma once
+#include <cmath>
+#include <span>
+#include <cstring>
+#include "Simd.cpp"
+
+enum class TestFunctionId { Parabola, Rastrigin, Custom };
+
+// cos(2*pi*x) без бібліотечного виклику. r = x - round(x) точне для |x| < 2^23,
+// далі симетрією зводимо до b із [0, 1/4] і рахуємо ряд Тейлора до y^12, y = 2*pi*b.
+// Залишок ряду менший за 1e-8, тож похибка визначається округленням float: < 2e-7 на всьому діапазоні
+namespace Cos2PiCoeffs {
+    constexpr float TwoPi = 6.28318530718f;
+    constexpr float C1 = -1.0f / 2.0f;
+    constexpr float C2 = 1.0f / 24.0f;
+    constexpr float C3 = -1.0f / 720.0f;
+    constexpr float C4 = 1.0f / 40320.0f;
+    constexpr float C5 = -1.0f / 3628800.0f;
+    constexpr float C6 = 1.0f / 479001600.0f;
+}
+
+inline float Cos2Pi(float x) {
+    using namespace Cos2PiCoeffs;
+    float a = std::fabs(x - std::nearbyint(x));
+    float b = std::min(a, 0.5f - a);
+    float sign = (a > 0.25f) ? -1.0f : 1.0f;
+    float y = TwoPi * b;
+    float z = y * y;
+    float p = ((((((C6 * z + C5) * z + C4) * z + C3) * z + C2) * z + C1) * z + 1.0f);
+    return sign * p;
+}
+
+// Усі функції сепарабельні: f(x) = сума t(x_d) + зсув. t(0) = 0 для кожної функції,
+// тож доповнення хвоста нулями не змінює суму
+inline float TestFunctionTerm(TestFunctionId id, float x) {
+    switch (id) {
+        case TestFunctionId::Rastrigin: return x * x - 10.0f * Cos2Pi(x) + 10.0f;
+        default: return x * x;
+    }
+}
+
+inline float TestFunctionOffset(TestFunctionId id) {
+    return (id == TestFunctionId::Custom) ? -2.0f : 0.0f;
+}
+
+inline float EvaluateTestFunction(TestFunctionId id, float x) {
+    return TestFunctionTerm(id, x) + TestFunctionOffset(id);
+}
+
+inline void EvaluateTestFunctionScalar(TestFunctionId id, const float* x, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = EvaluateTestFunction(id, x[i]);
+    }
+}
+
+inline void EvaluateTestFunctionRowsScalar(TestFunctionId id, const float* x, float* out, size_t count, size_t dimensions) {
+    const float offset = TestFunctionOffset(id);
+    for (size_t i = 0; i < count; ++i) {
+        const float* row = x + i * dimensions;
+        float sum = 0.0f;
+        for (size_t d = 0; d < dimensions; ++d) {
+            sum += TestFunctionTerm(id, row[d]);
+        }
+        out[i] = sum + offset;
+    }
+}
+
+#if SIMD_X86
+inline __m128 Cos2PiSse2(__m128 x) {
+    using namespace Cos2PiCoeffs;
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    // Від 2^23 float уже цілий, а від 2^31 перетворення в int32 переповнюється, тож такі x лишаються як є
+    __m128 large = _mm_cmpge_ps(_mm_and_ps(x, absMask), _mm_set1_ps(8388608.0f));
+    __m128 converted = _mm_cvtepi32_ps(_mm_cvtps_epi32(x));
+    __m128 rounded = _mm_or_ps(_mm_and_ps(large, x), _mm_andnot_ps(large, converted));
+    __m128 a = _mm_and_ps(_mm_sub_ps(x, rounded), absMask);
+    __m128 b = _mm_min_ps(a, _mm_sub_ps(_mm_set1_ps(0.5f), a));
+    __m128 signBit = _mm_and_ps(_mm_cmpgt_ps(a, _mm_set1_ps(0.25f)), _mm_set1_ps(-0.0f));
+    __m128 y = _mm_mul_ps(_mm_set1_ps(TwoPi), b);
+    __m128 z = _mm_mul_ps(y, y);
+    __m128 p = _mm_set1_ps(C6);
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(C5));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(C4));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(C3));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(C2));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(C1));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f));
+    return _mm_xor_ps(p, signBit);
+}
+
+inline __m128 TestFunctionTermSse2(TestFunctionId id, __m128 v) {
+    switch (id) {
+        case TestFunctionId::Rastrigin:
+            return _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v, v), _mm_mul_ps(_mm_set1_ps(10.0f), Cos2PiSse2(v))), _mm_set1_ps(10.0f));
+        default:
+            return _mm_mul_ps(v, v);
+    }
+}
+
+// Хвіст доповнюється до повного вектора, щоб кожен елемент рахувався тим самим кодом
+// незалежно від того, де проходить межа шматка
+inline void EvaluateTestFunctionSse2(TestFunctionId id, const float* x, float* out, size_t n) {
+    const __m128 offset = _mm_set1_ps(TestFunctionOffset(id));
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(TestFunctionTermSse2(id, _mm_loadu_ps(x + i)), offset));
+    }
+    if (i < n) {
+        float tail[4] = {};
+        std::memcpy(tail, x + i, (n - i) * sizeof(float));
+        _mm_storeu_ps(tail, _mm_add_ps(TestFunctionTermSse2(id, _mm_loadu_ps(tail)), offset));
+        std::memcpy(out + i, tail, (n - i) * sizeof(float));
+    }
+}
+
+inline float HorizontalSumSse2(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+// Багатовимірний випадок: вектор іде вздовж рядка, тож довгі рядки обробляються повними регістрами
+inline void EvaluateTestFunctionRowsSse2(TestFunctionId id, const float* x, float* out, size_t count, size_t dimensions) {
+    const float offset = TestFunctionOffset(id);
+    for (size_t i = 0; i < count; ++i) {
+        const float* row = x + i * dimensions;
+        __m128 sum = _mm_setzero_ps();
+        size_t d = 0;
+        for (; d + 4 <= dimensions; d += 4) {
+            sum = _mm_add_ps(sum, TestFunctionTermSse2(id, _mm_loadu_ps(row + d)));
+        }
+        if (d < dimensions) {
+            float tail[4] = {};
+            std::memcpy(tail, row + d, (dimensions - d) * sizeof(float));
+            sum = _mm_add_ps(sum, TestFunctionTermSse2(id, _mm_loadu_ps(tail)));
+        }
+        out[i] = HorizontalSumSse2(sum) + offset;
+    }
+}
+
+SIMD_TARGET_AVX2 inline __m256 Cos2PiAvx2(__m256 x) {
+    using namespace Cos2PiCoeffs;
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 rounded = _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 a = _mm256_and_ps(_mm256_sub_ps(x, rounded), absMask);
+    __m256 b = _mm256_min_ps(a, _mm256_sub_ps(_mm256_set1_ps(0.5f), a));
+    __m256 signBit = _mm256_and_ps(_mm256_cmp_ps(a, _mm256_set1_ps(0.25f), _CMP_GT_OQ), _mm256_set1_ps(-0.0f));
+    __m256 y = _mm256_mul_ps(_mm256_set1_ps(TwoPi), b);
+    __m256 z = _mm256_mul_ps(y, y);
+    __m256 p = _mm256_set1_ps(C6);
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(C5));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(C4));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(C3));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(C2));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(C1));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f));
+    return _mm256_xor_ps(p, signBit);
+}
+
+SIMD_TARGET_AVX2 inline __m256 TestFunctionTermAvx2(TestFunctionId id, __m256 v) {
+    switch (id) {
+        case TestFunctionId::Rastrigin:
+            return _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(10.0f), Cos2PiAvx2(v), _mm256_mul_ps(v, v)), _mm256_set1_ps(10.0f));
+        default:
+            return _mm256_mul_ps(v, v);
+    }
+}
+
+SIMD_TARGET_AVX2 inline void EvaluateTestFunctionAvx2(TestFunctionId id, const float* x, float* out, size_t n) {
+    const __m256 offset = _mm256_set1_ps(TestFunctionOffset(id));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(TestFunctionTermAvx2(id, _mm256_loadu_ps(x + i)), offset));
+    }
+    if (i < n) {
+        float tail[8] = {};
+        std::memcpy(tail, x + i, (n - i) * sizeof(float));
+        _mm256_storeu_ps(tail, _mm256_add_ps(TestFunctionTermAvx2(id, _mm256_loadu_ps(tail)), offset));
+        std::memcpy(out + i, tail, (n - i) * sizeof(float));
+    }
+}
+
+SIMD_TARGET_AVX2 inline void EvaluateTestFunctionRowsAvx2(TestFunctionId id, const float* x, float* out, size_t count, size_t dimensions) {
+    const float offset = TestFunctionOffset(id);
+    for (size_t i = 0; i < count; ++i) {
+        const float* row = x + i * dimensions;
+        __m256 sum = _mm256_setzero_ps();
+        size_t d = 0;
+        for (; d + 8 <= dimensions; d += 8) {
+            sum = _mm256_add_ps(sum, TestFunctionTermAvx2(id, _mm256_loadu_ps(row + d)));
+        }
+        if (d < dimensions) {
+            float tail[8] = {};
+            std::memcpy(tail, row + d, (dimensions - d) * sizeof(float));
+            sum = _mm256_add_ps(sum, TestFunctionTermAvx2(id, _mm256_loadu_ps(tail)));
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        out[i] = HorizontalSumSse2(half) + offset;
+    }
+}
+
+// GCC 12 хибно попереджає про _mm512_undefined_ps у заголовках AVX-512 (PR105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+SIMD_TARGET_AVX512 inline __m512 Cos2PiAvx512(__m512 x) {
+    using namespace Cos2PiCoeffs;
+    __m512 rounded = _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 a = _mm512_abs_ps(_mm512_sub_ps(x, rounded));
+    __m512 b = _mm512_min_ps(a, _mm512_sub_ps(_mm512_set1_ps(0.5f), a));
+    __mmask16 negative = _mm512_cmp_ps_mask(a, _mm512_set1_ps(0.25f), _CMP_GT_OQ);
+    __m512 y = _mm512_mul_ps(_mm512_set1_ps(TwoPi), b);
+    __m512 z = _mm512_mul_ps(y, y);
+    __m512 p = _mm512_set1_ps(C6);
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(C5));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(C4));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(C3));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(C2));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(C1));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(1.0f));
+    return _mm512_mask_sub_ps(p, negative, _mm512_setzero_ps(), p);
+}
+
+SIMD_TARGET_AVX512 inline __m512 TestFunctionTermAvx512(TestFunctionId id, __m512 v) {
+    switch (id) {
+        case TestFunctionId::Rastrigin:
+            return _mm512_add_ps(_mm512_fnmadd_ps(_mm512_set1_ps(10.0f), Cos2PiAvx512(v), _mm512_mul_ps(v, v)), _mm512_set1_ps(10.0f));
+        default:
+            return _mm512_mul_ps(v, v);
+    }
+}
+
+SIMD_TARGET_AVX512 inline __mmask16 TailMask16(size_t remaining) {
+    return (remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << remaining) - 1);
+}
+
+// Хвіст обробляється маскованими load/store, без скалярного циклу
+SIMD_TARGET_AVX512 inline void EvaluateTestFunctionAvx512(TestFunctionId id, const float* x, float* out, size_t n) {
+    const __m512 offset = _mm512_set1_ps(TestFunctionOffset(id));
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = TailMask16(n - i);
+        __m512 v = _mm512_maskz_loadu_ps(mask, x + i);
+        _mm512_mask_storeu_ps(out + i, mask, _mm512_add_ps(TestFunctionTermAvx512(id, v), offset));
+    }
+}
+
+SIMD_TARGET_AVX512 inline void EvaluateTestFunctionRowsAvx512(TestFunctionId id, const float* x, float* out, size_t count, size_t dimensions) {
+    const float offset = TestFunctionOffset(id);
+    for (size_t i = 0; i < count; ++i) {
+        const float* row = x + i * dimensions;
+        __m512 sum = _mm512_setzero_ps();
+        for (size_t d = 0; d < dimensions; d += 16) {
+            __mmask16 mask = TailMask16(dimensions - d);
+            sum = _mm512_add_ps(sum, TestFunctionTermAvx512(id, _mm512_maskz_loadu_ps(mask, row + d)));
+        }
+        out[i] = _mm512_reduce_add_ps(sum) + offset;
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// Оцінює всю популяцію найширшим доступним ядром. Одновимірні точки йдуть по вектору на кілька точок,
+// багатовимірні - по вектору вздовж рядка
+inline void EvaluateTestFunction(TestFunctionId id, std::span<const float> xs, std::span<float> out) {
+    if (out.empty()) return;
+    size_t dimensions = xs.size() / out.size();
+    if (dimensions != 1) {
+#if SIMD_X86
+        switch (GetSimdLevel()) {
+            case SimdLevel::Avx512:
+                EvaluateTestFunctionRowsAvx512(id, xs.data(), out.data(), out.size(), dimensions);
+                return;
+            case SimdLevel::Avx2:
+                EvaluateTestFunctionRowsAvx2(id, xs.data(), out.data(), out.size(), dimensions);
+                return;
+            case SimdLevel::Sse2:
+                EvaluateTestFunctionRowsSse2(id, xs.data(), out.data(), out.size(), dimensions);
+                return;
+            default:
+                break;
+        }
+#endif
+        EvaluateTestFunctionRowsScalar(id, xs.data(), out.data(), out.size(), dimensions);
+        return;
+    }
+
+#if SIMD_X86
+    switch (GetSimdLevel()) {
+        case SimdLevel::Avx512:
+            EvaluateTestFunctionAvx512(id, xs.data(), out.data(), xs.size());
+            return;
+        case SimdLevel::Avx2:
+            EvaluateTestFunctionAvx2(id, xs.data(), out.data(), xs.size());
+            return;
+        case SimdLevel::Sse2:
+            EvaluateTestFunctionSse2(id, xs.data(), out.data(), xs.size());
+            return;
+        default:
+            break;
+    }
+#endif
+    EvaluateTestFunctionScalar(id, xs.data(), out.data(), xs.size());
+}
+
+// Тестові функції як окремі типи: оптимізатори шаблонні за типом функції,
+// тож виклик вбудовується в цикл оцінювання без std::function.
+// Пакетний operator() оцінює всю популяцію SIMD-ядром; float(float) - для графіка в GUI
+struct Parabola {
+    float operator()(float x) const { return x * x; }
+    float operator()(std::span<const float> x) const {
+        float sum = 0.0f;
+        for (float value : x) sum += value * value;
+        return sum;
+    }
+    void operator()(std::span<const float> xs, std::span<float> out) const { EvaluateTestFunction(TestFunctionId::Parabola, xs, out); }
+};
+
+struct Rastrigin {
+    float operator()(float x) const {
+        const float pi = 3.14159265359f;
+        return x * x - 10.0f * cosf(2.0f * pi * x) + 10.0f;
+    }
+    float operator()(std::span<const float> x) const {
+        float sum = 0.0f;
+        for (float value : x) sum += (*this)(value);
+        return sum;
+    }
+    void operator()(std::span<const float> xs, std::span<float> out) const { EvaluateTestFunction(TestFunctionId::Rastrigin, xs, out); }
+};
+
+struct CustomFunction {
+    float operator()(float x) const { return (x * x) - 2; }
+    float operator()(std::span<const float> x) const { return Parabola{}(x) - 2; }
+    void operator()(std::span<const float> xs, std::span<float> out) const { EvaluateTestFunction(TestFunctionId::Custom, xs, out); }
+};
+
+// Ackley і Griewank не сепарабельні, тож пакетних SIMD-ядер не мають: популяцію оцінює BatchAdapter.
+// Обидві мають мінімум 0 у нулі
+struct Ackley {
+    float operator()(float x) const { return (*this)(std::span<const float>(&x, 1)); }
+    float operator()(std::span<const float> x) const {
+        float squares = 0.0f, cosines = 0.0f;
+        for (float value : x) {
+            squares += value * value;
+            cosines += Cos2Pi(value);
+        }
+        float n = static_cast<float>(x.size());
+        return -20.0f * std::exp(-0.2f * std::sqrt(squares / n)) - std::exp(cosines / n) + 20.0f + 2.71828182846f;
+    }
+};
+
+struct Griewank {
+    float operator()(float x) const { return (*this)(std::span<const float>(&x, 1)); }
+    float operator()(std::span<const float> x) const {
+        float sum = 0.0f, product = 1.0f;
+        for (size_t i = 0; i < x.size(); ++i) {
+            sum += x[i] * x[i];
+            product *= std::cos(x[i] / std::sqrt(static_cast<float>(i + 1)));
+        }
+        return 1.0f + sum / 4000.0f - product;
+    }
+};
+
+// Кількість варіантів WithTestFunction: індекси 0..TestFunctionCount-1
+inline constexpr int TestFunctionCount = 5;
+
+// Вибір функції один раз на виклик, а не на кожне оцінювання
+template <typename Fn>
+void WithTestFunction(int index, Fn&& fn) {
+    switch (index) {
+        case 1:
+            fn(Rastrigin{});
+            break;
+        case 2:
+            fn(CustomFunction{});
+            break;
+        case 3:
+            fn(Ackley{});
+            break;
+        case 4:
+            fn(Griewank{});
+            break;
+        default:
+            fn(Parabola{});
+            break;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// Постійний пул потоків для ParallelFor: потоки створюються один раз,
+// а потік, що викликає ParallelFor, теж бере участь у роботі
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Поточне завдання: fn(begin, end, chunkIndex) для кожного шматка [0, count)
+    void (*invoke)(void* fn, size_t begin, size_t end, size_t chunk);
+    void* job;
+    size_t jobCount;
+    size_t jobGrain;
+    size_t chunkCount;
+    std::atomic<size_t> nextChunk;
+    size_t finishedWorkers;
+    uint64_t epoch;
+    bool stopping;
+
+    void RunChunks() {
+        for (size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+            size_t begin = chunk * jobGrain;
+            invoke(job, begin, std::min(begin + jobGrain, jobCount), chunk);
+        }
+    }
+
+    void WorkerLoop() {
+        uint64_t seenEpoch = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeCondition.wait(lock, [&] { return stopping || epoch != seenEpoch; });
+                if (stopping) return;
+                seenEpoch = epoch;
+            }
+
+            RunChunks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finishedWorkers == workers.size()) {
+                doneCondition.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency())
+        : invoke(nullptr), job(nullptr), jobCount(0), jobGrain(1), chunkCount(0), nextChunk(0),
+          finishedWorkers(0), epoch(0), stopping(false) {
+        threadCount = std::max<size_t>(threadCount, 1);
+        for (size_t i = 1; i < threadCount; ++i) {
+            workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetThreadCount() const { return workers.size() + 1; }
+
+    // Ділить [0, count) на шматки по grain елементів і викликає fn(begin, end, chunkIndex).
+    // Межі шматків не залежать від кількості потоків
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t grain, Fn&& fn) {
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (chunks <= 1 || workers.empty()) {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                size_t begin = chunk * grain;
+                fn(begin, std::min(begin + grain, count), chunk);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            invoke = [](void* f, size_t begin, size_t end, size_t chunk) {
+                (*static_cast<std::remove_reference_t<Fn>*>(f))(begin, end, chunk);
+            };
+            job = const_cast<void*>(static_cast<const void*>(&fn));
+            jobCount = count;
+            jobGrain = grain;
+            chunkCount = chunks;
+            nextChunk.store(0);
+            finishedWorkers = 0;
+            ++epoch;
+        }
+        wakeCondition.notify_all();
+
+        RunChunks();
+
+        // Чекаємо всі робочі потоки, щоб жоден не звертався до fn після виходу
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return finishedWorkers == workers.size(); });
+    }
+};
+
+// Без пулу шматки виконуються послідовно з тими самими межами
+template <typename Fn>
+inline void ParallelFor(ThreadPool* pool, size_t count, size_t grain, Fn&& fn) {
+    if (pool) {
+        pool->ParallelFor(count, grain, fn);
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    for (size_t begin = 0, chunk = 0; begin < count; begin += grain, ++chunk) {
+        fn(begin, std::min(begin + grain, count), chunk);
+    }
+}
+
+// Розмір шматка для завдань, результат яких не залежить від меж шматків.
+// Без пулу - один шматок на весь діапазон
+inline size_t BalancedGrain(const ThreadPool* pool, size_t count) {
+    if (!pool) return std::max<size_t>(1, count);
+    return std::max<size_t>(1, count / (pool->GetThreadCount() * 4));
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Запис подій для Chrome trace / Perfetto. Кожен потік пише у власне кільце без блокувань
+// (єдиний письменник - сам потік); коли кільце повне, найстаріші події перезаписуються.
+// Подія зберігає і початок, і кінець, тому вивантажується як повна подія "X"
+struct TraceEvent {
+    const char* name; // рядковий літерал
+    uint64_t begin;   // нс від Start()
+    uint64_t end;
+};
+
+class TraceRecorder {
+private:
+    struct ThreadBuffer {
+        uint32_t threadId;
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> written{ 0 }; // усього записано, включно з перезаписаними
+
+        void Push(const TraceEvent& event) {
+            uint64_t index = written.load(std::memory_order_relaxed);
+            events[index % events.size()] = event;
+            written.store(index + 1, std::memory_order_release);
+        }
+    };
+
+    std::atomic<bool> enabled{ false };
+    std::chrono::steady_clock::time_point origin;
+    size_t capacity = 0;
+    std::mutex registryMutex; // лише для реєстрації потоку, не для запису подій
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint64_t> epoch{ 0 }; // збільшується на кожен Start, щоб потоки перевіряли свої кільця
+
+    ThreadBuffer* LocalBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        thread_local uint64_t bufferEpoch = 0;
+        uint64_t current = epoch.load(std::memory_order_acquire);
+        if (!buffer || bufferEpoch != current) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            if (!buffer) {
+                buffers.push_back(std::make_unique<ThreadBuffer>());
+                buffer = buffers.back().get();
+                buffer->threadId = static_cast<uint32_t>(buffers.size() - 1);
+            }
+            if (buffer->events.size() != capacity) buffer->events.assign(capacity, TraceEvent{});
+            bufferEpoch = current;
+        }
+        return buffer;
+    }
+
+public:
+    // Починає новий запис; capacity - подій на потік. Викликати, коли жоден потік не пише події
+    void Start(size_t eventsPerThread = size_t(1) << 20) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        capacity = eventsPerThread > 0 ? eventsPerThread : 1;
+        for (auto& buffer : buffers) {
+            buffer->written.store(0, std::memory_order_relaxed);
+        }
+        origin = std::chrono::steady_clock::now();
+        epoch.fetch_add(1, std::memory_order_release);
+        enabled.store(true, std::memory_order_release);
+    }
+
+    void Stop() { enabled.store(false, std::memory_order_release); }
+
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    uint64_t Timestamp(std::chrono::steady_clock::time_point time) const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin).count());
+    }
+
+    void Record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+        if (!IsEnabled()) return;
+        LocalBuffer()->Push(TraceEvent{ name, Timestamp(begin), Timestamp(end) });
+    }
+
+    // Записує події всіх потоків у форматі Chrome trace-event JSON. Викликати після Stop(),
+    // коли потоки вже не пишуть. Повертає false, якщо файл не вдалося записати; кількість подій,
+    // втрачених через переповнення кілець, кладе в dropped
+    bool WriteChromeTrace(const std::string& path, uint64_t* dropped = nullptr) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        uint64_t lost = 0;
+        bool first = true;
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (const auto& buffer : buffers) {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            if (written == 0 || buffer->events.empty()) continue;
+            uint64_t size = buffer->events.size();
+            uint64_t firstIndex = written > size ? written - size : 0;
+            lost += firstIndex;
+
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                         first ? "" : ",\n", buffer->threadId, buffer->threadId);
+            first = false;
+            for (uint64_t i = firstIndex; i < written; ++i) {
+                const TraceEvent& event = buffer->events[i % size];
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             event.name, buffer->threadId, event.begin * 1e-3, (event.end - event.begin) * 1e-3);
+            }
+        }
+        std::fprintf(file, "\n]}\n");
+        bool ok = std::ferror(file) == 0;
+        ok = (std::fclose(file) == 0) && ok;
+        if (dropped) *dropped = lost;
+        return ok;
+    }
+};
+
+inline TraceRecorder& GlobalTrace() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+// Подія лише для трасування, без фази профайлера (наприклад, ціле покоління)
+class TraceScope {
+private:
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit TraceScope(const char* eventName) : name(eventName) {
+        if (GlobalTrace().IsEnabled()) start = std::chrono::steady_clock::now();
+    }
+
+    ~TraceScope() {
+        if (GlobalTrace().IsEnabled()) GlobalTrace().Record(name, start, std::chrono::steady_clock::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
@@ -6,9 +6,15 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cfloat>
+#include <cstdio>
+#include "ThreadPool.cpp"
+#include "TestFunctions.cpp"
 #include "GA.cpp"
 #include "GWO.cpp"
 #include "DrawScene.cpp"
+#include "OptimizerRunner.cpp"
+#include "Profiler.cpp"
 
 // Глобальні змінні
 GLFWwindow* window;
@@ -16,8 +22,12 @@ const char* glsl_version = "#version 130";
 const int WINDOW_WIDTH = 1200;
 const int WINDOW_HEIGHT = 800;
 
-GeneticAlgorithm ga;
-GreyWolfOptimizer gwo;
+ThreadPool threadPool;
+// Графік одновимірний, тож вимірність фіксована на етапі компіляції
+GeneticAlgorithm<1> ga;
+GreyWolfOptimizer<1> gwo;
+// Оголошений після оптимізаторів, тож його потік зупиняється раніше, ніж вони руйнуються
+OptimizerRunner runner;
 FunctionDrawer drawer;
 
 // Налаштування GUI
@@ -27,29 +37,38 @@ int maxGenerations = 100;
 float crossoverRate = 0.8f;
 float mutationRate = 0.1f;
 int chromosomeLength = 16;
+const char* crossoverTypes[] = { "Single-point", "Two-point", "Uniform" };
+int crossoverType = 0;
+bool grayCoding = false;
+bool fitnessCache = false;
+FitnessCacheStats cacheStats;
+int tournamentSize = 3;
 float searchMin = -10.0f;
 float searchMax = 10.0f;
-bool isRunning = false;
+bool multiThreaded = false;
+uint64_t seed = 1;
+bool randomSeed = false;
+int generationRate = 0; // 0 - без обмеження
+bool showProfiler = false;
 int currentGeneration = 0;
 std::vector<float> bestPositions;
+// Криві збіжності з кільця телеметрії вибраного оптимізатора; пам'ять резервується один раз в Initialize
+GenerationStats telemetrySamples[TelemetryRing::Capacity];
 std::vector<float> bestFitnessHistory;
+std::vector<float> meanFitnessHistory;
+GenerationStats latestStats;
+const TelemetryRing* telemetrySource = nullptr;
+uint64_t telemetryRecorded = 0;
 
 // Тестові функції
-const char* testFunctions[] = { "Parabola", "Rastrigin", "Custom Function" };
+const char* testFunctions[] = { "Parabola", "Rastrigin", "Custom Function", "Ackley", "Griewank" };
 int selectedFunction = 0;
 
+// Для GUI (малювання графіка); оптимізатори отримують конкретний тип через WithTestFunction
 float TestFunction(float x) {
-    const float pi = 3.14159265359f;
-    switch (selectedFunction) {
-        case 0: // Parabolic
-            return x * x;
-        case 1: // Rastrigin
-            return x * x - 10.0f * cosf(2.0f * pi * x) + 10.0f;
-        case 2: // custom 
-            return (x*x)-2;
-        default:
-            return x * x;
-    }
+    float result = 0.0f;
+    WithTestFunction(selectedFunction, [&](auto function) { result = function(x); });
+    return result;
 }
 
 void Initialize() {
@@ -82,30 +101,167 @@ void Initialize() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
-    // Ініціалізація алгоритмів
-    ga.Initialize(static_cast<size_t>(populationSize), static_cast<size_t>(chromosomeLength),searchMin, searchMax, crossoverRate, mutationRate);
-    ga.EvaluateFitness(TestFunction);
-    gwo.Initialize(static_cast<size_t>(populationSize), searchMin, searchMax);
+    // Ініціалізація алгоритмів; телеметрія потрібна графіку збіжності
+    ga.EnableTelemetry(true);
+    gwo.EnableTelemetry(true);
+    ga.Initialize(static_cast<size_t>(populationSize), static_cast<size_t>(chromosomeLength),searchMin, searchMax, crossoverRate, mutationRate, seed,
+                  static_cast<CrossoverType>(crossoverType), grayCoding,
+                  static_cast<size_t>(tournamentSize));
+    WithTestFunction(selectedFunction, [](auto function) { ga.EvaluateFitness(function); });
+    gwo.Initialize(static_cast<size_t>(populationSize), searchMin, searchMax, seed);
     drawer.Initialize(searchMin, searchMax, TestFunction);
+    bestFitnessHistory.reserve(TelemetryRing::Capacity);
+    meanFitnessHistory.reserve(TelemetryRing::Capacity);
 }
 
-void Update() {
-    if (!isRunning) return;
+// Оновлює криві, лише коли в кільці з'явилися нові покоління або змінився оптимізатор;
+// кільце можна читати й під час роботи фонового потоку
+void ReadTelemetry(bool force = false) {
+    const TelemetryRing& ring = selectedAlgorithm == 0 ? ga.GetTelemetry() : gwo.GetTelemetry();
+    uint64_t recorded = ring.TotalRecorded();
+    if (!force && &ring == telemetrySource && recorded == telemetryRecorded) return;
+    telemetrySource = &ring;
+    telemetryRecorded = recorded;
+
+    size_t count = ring.CopyHistory(telemetrySamples);
+    bestFitnessHistory.resize(count);
+    meanFitnessHistory.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        bestFitnessHistory[i] = telemetrySamples[i].best;
+        meanFitnessHistory[i] = telemetrySamples[i].mean;
+    }
+    latestStats = count > 0 ? telemetrySamples[count - 1] : GenerationStats();
+}
+
+// Після першого виклику пам'ять вектора лише перевикористовується
+void CopyPositions(std::span<const float> from, std::vector<float>& to) {
+    to.assign(from.begin(), from.end());
+}
 
-    if (selectedAlgorithm == 0) { // GA
-        ga.RunGeneration(TestFunction);
+// Стан вибраного оптимізатора напряму; лише коли фоновий потік на паузі
+void ReadResults() {
+    if (selectedAlgorithm == 0) {
         currentGeneration = ga.GetCurrentGeneration();
-        bestPositions = ga.GetBestPositions();
-    } else { // GWO
-        gwo.RunGeneration(TestFunction);
+        CopyPositions(ga.GetBestPositions(), bestPositions);
+        cacheStats = ga.GetFitnessCacheStats();
+    } else {
         currentGeneration = gwo.GetCurrentGeneration();
-        bestPositions = gwo.GetBestPositions();
+        CopyPositions(gwo.GetBestPositions(), bestPositions);
+    }
+}
+
+// Покоління йдуть на фоновому потоці; алгоритм, функція і ліміт фіксуються в момент запуску
+void StartRunner() {
+    int algorithm = selectedAlgorithm;
+    int function = selectedFunction;
+    int generations = maxGenerations;
+    runner.Start([=](OptimizerSnapshot& snapshot) {
+        if (algorithm == 0) { // GA
+            WithTestFunction(function, [](auto f) { ga.RunGeneration(f); });
+            snapshot.generation = ga.GetCurrentGeneration();
+            CopyPositions(ga.GetBestPositions(), snapshot.bestPositions);
+            snapshot.cacheStats = ga.GetFitnessCacheStats();
+        } else { // GWO
+            WithTestFunction(function, [](auto f) { gwo.RunGeneration(f); });
+            snapshot.generation = gwo.GetCurrentGeneration();
+            CopyPositions(gwo.GetBestPositions(), snapshot.bestPositions);
+        }
+        return snapshot.generation < generations;
+    });
+}
+
+// Кадр лише забирає останній знімок, сам оптимізатор не чекає на vsync.
+// Вектори знімка й кадру зберігають ємність, тож копіювання не виділяє пам'ять
+void Update() {
+    PROFILE_SCOPE(ProfilePhase::FrameUpdate);
+    if (runner.PollSnapshot()) {
+        const OptimizerSnapshot& snapshot = runner.GetSnapshot();
+        currentGeneration = snapshot.generation;
+        bestPositions.assign(snapshot.bestPositions.begin(), snapshot.bestPositions.end());
+        cacheStats = snapshot.cacheStats;
     }
+    ReadTelemetry();
+}
 
-    if (currentGeneration >= maxGenerations) {
-        isRunning = false;
+// Найкраще і середнє значення цільової функції за поколіннями, над графіком функції
+void DrawConvergencePlot() {
+    int count = static_cast<int>(bestFitnessHistory.size());
+    float width = (ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ItemSpacing.x) * 0.5f;
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "best %.6g", latestStats.best);
+    ImGui::PlotLines("##bestFitness", bestFitnessHistory.data(), count, 0, overlay, FLT_MAX, FLT_MAX, ImVec2(width, 110.0f));
+    ImGui::SameLine();
+    std::snprintf(overlay, sizeof(overlay), "mean %.6g", latestStats.mean);
+    ImGui::PlotLines("##meanFitness", meanFitnessHistory.data(), count, 0, overlay, FLT_MAX, FLT_MAX, ImVec2(width, 110.0f));
+    ImGui::Text("Generation %d: worst %.6g, diversity %.4g, %llu evaluations", latestStats.generation, latestStats.worst,
+                latestStats.diversity, static_cast<unsigned long long>(latestStats.evaluations));
+    ImGui::Separator();
+}
+
+// Вікно профайлера: для кожної фази - останній і середній час, частка в групі та гістограма останніх зразків.
+// Фази оптимізатора - за покоління (сума часу всіх потоків), фази кадру - за кадр
+void DrawProfilerWindow() {
+    ImGui::SetNextWindowPos(ImVec2(420, 420), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(760, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", &showProfiler)) {
+        ImGui::End();
+        return;
+    }
+    if (!DEMO_PROFILING) {
+        ImGui::TextUnformatted("Profiling is compiled out (build with DEMO_PROFILING=ON)");
+        ImGui::End();
+        return;
     }
-} 
+
+    static float samples[Profiler::HistoryLength];
+    for (ProfileGroup group : { ProfileGroup::Optimizer, ProfileGroup::Frame }) {
+        ImGui::SeparatorText(group == ProfileGroup::Optimizer ? "Per generation" : "Per frame");
+
+        // Спершу середні, щоб порахувати частки в групі; вкладені фази показуються з відступом під батьківською
+        float means[Profiler::PhaseCount] = {};
+        float groupTotal = 0.0f;
+        for (size_t p = 0; p < Profiler::PhaseCount; ++p) {
+            ProfilePhase phase = static_cast<ProfilePhase>(p);
+            if (ProfilePhaseGroup(phase) != group) continue;
+            size_t count = GlobalProfiler().CopyHistory(phase, samples);
+            for (size_t i = 0; i < count; ++i) means[p] += samples[i];
+            if (count > 0) means[p] /= static_cast<float>(count);
+            if (ProfilePhaseParent(phase) == ProfilePhase::Count) groupTotal += means[p];
+        }
+
+        if (!ImGui::BeginTable(group == ProfileGroup::Optimizer ? "optimizer" : "frame", 5, ImGuiTableFlags_RowBg)) continue;
+        ImGui::TableSetupColumn("Phase", ImGuiTableColumnFlags_WidthFixed, 150.0f);
+        ImGui::TableSetupColumn("Last ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("Mean ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("%", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+        ImGui::TableSetupColumn("History");
+        ImGui::TableHeadersRow();
+        for (size_t p = 0; p < Profiler::PhaseCount; ++p) {
+            ProfilePhase phase = static_cast<ProfilePhase>(p);
+            if (ProfilePhaseGroup(phase) != group) continue;
+            size_t count = GlobalProfiler().CopyHistory(phase, samples);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            bool nested = ProfilePhaseParent(phase) != ProfilePhase::Count;
+            if (nested) ImGui::Indent();
+            ImGui::TextUnformatted(ProfilePhaseName(phase));
+            if (nested) ImGui::Unindent();
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", count > 0 ? samples[count - 1] : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", means[p]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", groupTotal > 0.0f ? means[p] / groupTotal * 100.0f : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::PushID(static_cast<int>(p));
+            ImGui::PlotHistogram("##history", samples, static_cast<int>(count), 0, nullptr, 0.0f, FLT_MAX, ImVec2(-1.0f, 18.0f));
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
 
 void Render() {
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -130,8 +286,9 @@ void Render() {
 
     // Вибір алгоритму
     ImGui::Text("Optimization Algorithm");
-    ImGui::RadioButton("Genetic Algorithm", &selectedAlgorithm, 0);
-    ImGui::RadioButton("Grey Wolf Optimizer", &selectedAlgorithm, 1);
+    bool runSettingsChanged = false;
+    runSettingsChanged |= ImGui::RadioButton("Genetic Algorithm", &selectedAlgorithm, 0);
+    runSettingsChanged |= ImGui::RadioButton("Grey Wolf Optimizer", &selectedAlgorithm, 1);
     ImGui::Separator();
 
     // Вибір функції
@@ -141,53 +298,95 @@ void Render() {
 
     ImGui::Text("Common Parameters");
     ImGui::SliderInt("Population Size", &populationSize, 10, 200);
-    ImGui::SliderInt("Max Generations", &maxGenerations, 10, 500);
+    runSettingsChanged |= ImGui::SliderInt("Max Generations", &maxGenerations, 10, 500);
     bool rangeChanged = false;
     rangeChanged |= ImGui::SliderFloat("Search Min", &searchMin, -10.0f, 0.0f);
     rangeChanged |= ImGui::SliderFloat("Search Max", &searchMax, 0.0f, 10.0f);
+    if (ImGui::Checkbox("Multi-threaded", &multiThreaded)) {
+        bool wasRunning = runner.IsRunning();
+        runner.Pause();
+        ga.SetThreadPool(multiThreaded ? &threadPool : nullptr);
+        gwo.SetThreadPool(multiThreaded ? &threadPool : nullptr);
+        if (wasRunning) StartRunner();
+    }
+    if (ImGui::SliderInt("Speed", &generationRate, 0, 1000, generationRate == 0 ? "Unlimited" : "%d gen/s")) {
+        runner.SetRateLimit(generationRate);
+    }
+    ImGui::InputScalar("Seed", ImGuiDataType_U64, &seed);
+    ImGui::Checkbox("Random Seed", &randomSeed);
+    ImGui::Text("SIMD: %s", SimdLevelName(GetSimdLevel()));
+    ImGui::Checkbox("Show Profiler", &showProfiler);
 
     if (selectedAlgorithm == 0) {
         ImGui::Separator();
         ImGui::Text("Genetic Algorithm Parameters");
         ImGui::SliderFloat("Crossover Rate", &crossoverRate, 0.0f, 1.0f, "%.2f");
+        ImGui::Combo("Crossover", &crossoverType, crossoverTypes, IM_ARRAYSIZE(crossoverTypes));
+        ImGui::SliderInt("Tournament Size", &tournamentSize, 2, 10);
         ImGui::SliderFloat("Mutation Rate", &mutationRate, 0.0f, 1.0f, "%.2f");
         ImGui::SliderInt("Chromosome Length", &chromosomeLength, 8, 32);
+        ImGui::Checkbox("Gray Code", &grayCoding);
+        if (ImGui::Checkbox("Fitness Cache", &fitnessCache)) {
+            bool wasRunning = runner.IsRunning();
+            runner.Pause();
+            ga.EnableFitnessCache(fitnessCache);
+            if (wasRunning) StartRunner();
+        }
+        if (fitnessCache) {
+            ImGui::Text("Cache: %llu hits, %llu misses (%.1f%%)", static_cast<unsigned long long>(cacheStats.hits),
+                        static_cast<unsigned long long>(cacheStats.misses), cacheStats.HitRate() * 100.0);
+        }
     }
         
+    // Запущений прогін підхоплює нові налаштування без зупинки
+    if ((runSettingsChanged || functionChanged) && runner.IsRunning()) {
+        StartRunner();
+    }
+
     if (rangeChanged || functionChanged) {
         drawer.Initialize(searchMin, searchMax, TestFunction);
     }
 
     // Керування симуляцією
     ImGui::Text("Simulation Control");
-    if (ImGui::Button(isRunning ? "Pause" : "Start")) {
-        isRunning = !isRunning;
+    if (ImGui::Button(runner.IsRunning() ? "Pause" : "Start")) {
+        if (runner.IsRunning()) {
+            runner.Pause();
+            ReadResults();
+        } else {
+            StartRunner();
+        }
     }
     ImGui::SameLine();
     if (ImGui::Button("Reset")) {
-        isRunning = false;
+        runner.Pause();
         currentGeneration = 0;
+        cacheStats = FitnessCacheStats();
+        // Новий випадковий seed лишається в полі, щоб запуск можна було повторити
+        if (randomSeed) seed = RandomSeed();
         if (selectedAlgorithm == 0) {
-            ga.Initialize(static_cast<size_t>(populationSize), static_cast<size_t>(chromosomeLength), searchMin, searchMax, crossoverRate, mutationRate);
-            ga.EvaluateFitness(TestFunction);
+            ga.Initialize(static_cast<size_t>(populationSize), static_cast<size_t>(chromosomeLength), searchMin, searchMax, crossoverRate, mutationRate, seed,
+                          static_cast<CrossoverType>(crossoverType), grayCoding,
+                          static_cast<size_t>(tournamentSize));
+            WithTestFunction(selectedFunction, [](auto function) { ga.EvaluateFitness(function); });
         } else {
-            gwo.Initialize(static_cast<size_t>(populationSize), searchMin, searchMax);
+            gwo.Initialize(static_cast<size_t>(populationSize), searchMin, searchMax, seed);
         }
         drawer.Initialize(searchMin, searchMax, TestFunction);
         bestPositions.clear();
+        ReadTelemetry(true);
+        GlobalProfiler().Reset();
     }
 
     ImGui::SameLine();
     if (ImGui::Button("Step")) {
+        runner.Pause();
         if (selectedAlgorithm == 0) {
-            ga.RunGeneration(TestFunction);
-            bestPositions = ga.GetBestPositions();
-            currentGeneration = ga.GetCurrentGeneration();
+            WithTestFunction(selectedFunction, [](auto function) { ga.RunGeneration(function); });
         } else {
-            gwo.RunGeneration(TestFunction);
-            bestPositions = gwo.GetBestPositions();
-            currentGeneration = gwo.GetCurrentGeneration();
+            WithTestFunction(selectedFunction, [](auto function) { gwo.RunGeneration(function); });
         }
+        ReadResults();
     }
 
     ImGui::Text("Generation: %d/%d", currentGeneration, maxGenerations);
@@ -206,7 +405,8 @@ void Render() {
     ImGui::SetNextWindowPos(ImVec2(400, 0));
     ImGui::SetNextWindowSize(ImVec2(WINDOW_WIDTH - 400, WINDOW_HEIGHT));
     ImGui::Begin("Visualization", nullptr, visualizationFlags);
-    
+
+    DrawConvergencePlot();
     drawer.DrawFunction();
     if (!bestPositions.empty()) {
         drawer.DrawSolutions(bestPositions);
@@ -214,10 +414,12 @@ void Render() {
     
     ImGui::End();
 
+    if (showProfiler) {
+        DrawProfilerWindow();
+    }
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-    glfwSwapBuffers(window);
 }
 
 void Cleanup() {
@@ -235,9 +437,17 @@ int main() {
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
         Update();
-        Render();
+        {
+            // Без очікування vsync у glfwSwapBuffers
+            PROFILE_SCOPE(ProfilePhase::FrameRender);
+            Render();
+        }
+        glfwSwapBuffers(window);
+        PROFILE_COMMIT(ProfileGroup::Frame);
     }
 
+    // Покоління в польоті має завершитися до того, як почнуть руйнуватися статичні об'єкти (профайлер, трасування)
+    runner.Pause();
     Cleanup();
     return 0;
 }